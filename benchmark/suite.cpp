@@ -0,0 +1,304 @@
+// Benchmark suite for the C++ solvers, intended as a performance
+// regression gate. Unlike main.cpp, which compares against Fortran ARPACK
+// and therefore needs libarpack, this program only exercises the headers
+// in ../include, so it can run anywhere the library compiles.
+//
+// Usage:
+//   suite.out                          print CSV results to stdout
+//   suite.out --out FILE               also write the CSV to FILE
+//   suite.out --baseline FILE          compare against a stored CSV and
+//                                      report per-case slowdowns
+//   suite.out --threshold X            flag cases slower than X times the
+//                                      baseline (default 1.25); exits with
+//                                      a nonzero status if any case fails
+//   suite.out --reps K                 median of K timed runs (default 5)
+//
+// Each case runs one warmup solve before the timed repetitions, and the
+// reported time is the median over the repetitions.
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+#include <MatOp/DenseSymShiftSolve.h>
+#include <MatOp/DenseGenRealShiftSolve.h>
+#include <MatOp/SparseGenMatProd.h>
+#include <MatOp/SparseSymShiftSolve.h>
+#include <MatOp/SparseGenRealShiftSolve.h>
+
+#include "timer.h"
+
+struct Result
+{
+    std::string name;
+    int n, nev, ncv;
+    int nconv;
+    double median_ms;
+    double resid;
+};
+
+std::vector<Result> results;
+
+template <typename Solver>
+double run_timed(Solver &eigs, int &nconv)
+{
+    double start = get_wall_time();
+    srand(123);
+    eigs.init();
+    nconv = eigs.compute();
+    return (get_wall_time() - start) * 1000;
+}
+
+template <typename Solver>
+void time_case(const std::string &name, Solver &eigs, int n, int nev, int ncv,
+               int reps, double resid)
+{
+    int nconv = 0;
+    run_timed(eigs, nconv);  // warmup
+    std::vector<double> times(reps);
+    for(int r = 0; r < reps; r++)
+        times[r] = run_timed(eigs, nconv);
+    std::sort(times.begin(), times.end());
+
+    Result res;
+    res.name = name;
+    res.n = n;
+    res.nev = nev;
+    res.ncv = ncv;
+    res.nconv = nconv;
+    res.median_ms = times[reps / 2];
+    res.resid = resid;
+    results.push_back(res);
+    std::cerr << "done: " << name << " (" << res.median_ms << " ms)" << std::endl;
+}
+
+template <typename Scalar>
+std::string scalar_name() { return "double"; }
+template <>
+std::string scalar_name<float>() { return "float"; }
+
+template <typename Scalar>
+std::string case_name(const std::string &kind, int n, int nev, int ncv)
+{
+    std::ostringstream name;
+    name << kind << "_" << scalar_name<Scalar>()
+         << "_n" << n << "_k" << nev << "_m" << ncv;
+    return name.str();
+}
+
+// Sparse random matrix with around 10 nonzeros per row
+template <typename Scalar>
+Eigen::SparseMatrix<Scalar> sprand(int n)
+{
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    const double prob = 10.0 / n;
+    Matrix dense = Matrix::Random(n, n);
+    Eigen::SparseMatrix<Scalar> mat(n, n);
+    for(int j = 0; j < n; j++)
+        for(int i = 0; i < n; i++)
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+                mat.insert(i, j) = dense(i, j);
+    mat.makeCompressed();
+    return mat;
+}
+
+template <typename Scalar>
+void bench_dense(int n, int nev, int ncv, int reps)
+{
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+    srand(123);
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = A + A.transpose();
+
+    {
+        DenseGenMatProd<Scalar> op(M);
+        SymEigsSolver<Scalar, LARGEST_MAGN, DenseGenMatProd<Scalar>> eigs(&op, nev, ncv);
+        time_case(case_name<Scalar>("sym_dense", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        DenseSymShiftSolve<Scalar> op(M);
+        SymEigsShiftSolver<Scalar, LARGEST_MAGN, DenseSymShiftSolve<Scalar>> eigs(&op, nev, ncv, Scalar(1));
+        time_case(case_name<Scalar>("sym_dense_shift", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        DenseGenMatProd<Scalar> op(A);
+        GenEigsSolver<Scalar, LARGEST_MAGN, DenseGenMatProd<Scalar>> eigs(&op, nev, ncv);
+        time_case(case_name<Scalar>("gen_dense", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        DenseGenRealShiftSolve<Scalar> op(A);
+        GenEigsRealShiftSolver<Scalar, LARGEST_MAGN, DenseGenRealShiftSolve<Scalar>> eigs(&op, nev, ncv, Scalar(1));
+        time_case(case_name<Scalar>("gen_dense_shift", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+}
+
+// The sparse shift-solve wrappers factorize in double only, so sparse
+// workloads are not templated on the scalar type
+void bench_sparse(int n, int nev, int ncv, int reps)
+{
+    typedef Eigen::SparseMatrix<double> SpMatrix;
+
+    srand(123);
+    SpMatrix A = sprand<double>(n);
+    SpMatrix M = SpMatrix(A.transpose()) + A;
+
+    {
+        SparseGenMatProd<double> op(M);
+        SymEigsSolver<double, LARGEST_MAGN, SparseGenMatProd<double>> eigs(&op, nev, ncv);
+        time_case(case_name<double>("sym_sparse", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        SparseSymShiftSolve<double> op(M);
+        SymEigsShiftSolver<double, LARGEST_MAGN, SparseSymShiftSolve<double>> eigs(&op, nev, ncv, 1.0);
+        time_case(case_name<double>("sym_sparse_shift", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        SparseGenMatProd<double> op(A);
+        GenEigsSolver<double, LARGEST_MAGN, SparseGenMatProd<double>> eigs(&op, nev, ncv);
+        time_case(case_name<double>("gen_sparse", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+    {
+        SparseGenRealShiftSolve<double> op(A);
+        GenEigsRealShiftSolver<double, LARGEST_MAGN, SparseGenRealShiftSolve<double>> eigs(&op, nev, ncv, 1.0);
+        time_case(case_name<double>("gen_sparse_shift", n, nev, ncv), eigs, n, nev, ncv, reps, 0);
+    }
+}
+
+void write_csv(std::ostream &out)
+{
+    out << "case,n,nev,ncv,nconv,median_ms\n";
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        out << r.name << "," << r.n << "," << r.nev << "," << r.ncv << ","
+            << r.nconv << "," << r.median_ms << "\n";
+    }
+}
+
+// Read a CSV produced by write_csv() into a name -> median_ms map
+std::map<std::string, double> read_baseline(const std::string &file)
+{
+    std::map<std::string, double> base;
+    std::ifstream in(file.c_str());
+    if(!in)
+    {
+        std::cerr << "cannot open baseline file " << file << std::endl;
+        std::exit(2);
+    }
+    std::string line;
+    std::getline(in, line);  // header
+    while(std::getline(in, line))
+    {
+        std::istringstream ss(line);
+        std::string field;
+        std::vector<std::string> fields;
+        while(std::getline(ss, field, ','))
+            fields.push_back(field);
+        if(fields.size() >= 6)
+            base[fields[0]] = std::atof(fields[5].c_str());
+    }
+    return base;
+}
+
+int compare_baseline(const std::string &file, double threshold)
+{
+    std::map<std::string, double> base = read_baseline(file);
+    int nregress = 0;
+
+    std::cout << std::endl
+              << std::left << std::setw(40) << "case"
+              << std::right << std::setw(14) << "baseline/ms"
+              << std::setw(14) << "current/ms"
+              << std::setw(10) << "ratio" << std::endl;
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        std::map<std::string, double>::const_iterator it = base.find(r.name);
+        if(it == base.end())
+        {
+            std::cout << std::left << std::setw(40) << r.name
+                      << "  (not in baseline)" << std::endl;
+            continue;
+        }
+        double ratio = r.median_ms / it->second;
+        std::cout << std::left << std::setw(40) << r.name
+                  << std::right << std::setw(14) << it->second
+                  << std::setw(14) << r.median_ms
+                  << std::setw(10) << std::setprecision(3) << ratio;
+        if(ratio > threshold)
+        {
+            std::cout << "  REGRESSION";
+            nregress++;
+        }
+        std::cout << std::endl;
+    }
+    if(nregress)
+        std::cout << std::endl << nregress << " case(s) exceeded the threshold of "
+                  << threshold << std::endl;
+    return nregress ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string out_file, baseline_file;
+    double threshold = 1.25;
+    int reps = 5;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--out" && i + 1 < argc)
+            out_file = argv[++i];
+        else if(arg == "--baseline" && i + 1 < argc)
+            baseline_file = argv[++i];
+        else if(arg == "--threshold" && i + 1 < argc)
+            threshold = std::atof(argv[++i]);
+        else if(arg == "--reps" && i + 1 < argc)
+            reps = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    // (n, nev, ncv) grid
+    const int grid[][3] = {
+        {100,  10, 30},
+        {1000, 10, 30},
+        {1000, 20, 60},
+        {2000, 10, 30},
+    };
+    const int ngrid = sizeof(grid) / sizeof(grid[0]);
+
+    for(int g = 0; g < ngrid; g++)
+    {
+        bench_dense<double>(grid[g][0], grid[g][1], grid[g][2], reps);
+        bench_dense<float>(grid[g][0], grid[g][1], grid[g][2], reps);
+        bench_sparse(grid[g][0], grid[g][1], grid[g][2], reps);
+    }
+
+    write_csv(std::cout);
+    if(!out_file.empty())
+    {
+        std::ofstream out(out_file.c_str());
+        write_csv(out);
+    }
+
+    if(!baseline_file.empty())
+        return compare_baseline(baseline_file, threshold);
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BASIS_GEMV_H
+#define BASIS_GEMV_H
+
+#include <Eigen/Core>
+
+///
+/// \ingroup EigenSolver
+///
+/// The default implementation of the basis matrix-vector products used
+/// by GenEigsSolver::factorize_from(). Apart from perform_op(), these
+/// products against the \f$n\times ncv\f$ basis \f$V\f$ are the only
+/// per-iteration operations that touch length-\f$n\f$ data, so routing
+/// them through a policy class makes it possible to keep the basis in
+/// accelerator or otherwise non-host-managed memory: a custom policy can
+/// run the products where the basis lives, while the solver itself only
+/// handles the small \f$ncv\f$-sized coefficient vectors it receives
+/// back.
+///
+/// A device-backed policy would typically be paired with the external
+/// basis buffer constructor of the solver, handing it an allocation
+/// (e.g. CUDA unified memory) that both sides can address; the solver
+/// reads the basis only outside the iteration loop, so the per-iteration
+/// traffic reduces to the coefficient vectors. This class is the plain
+/// host implementation, mapping the raw pointers back into **Eigen**
+/// expressions, and compiles to exactly the products the solver used to
+/// perform itself.
+///
+/// All pointers refer to column-major data; `V` has column stride `n`.
+///
+template <typename Scalar>
+class HostBasisGemv
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<const Matrix> MapConstMat;
+    typedef Eigen::Map<const Vector> MapConstVec;
+    typedef Eigen::Map<Vector> MapVec;
+
+public:
+    ///
+    /// Projection on the basis: \f$h=V(:,0\ldots ncols-1)'w\f$.
+    ///
+    void project(const Scalar *V, int n, int ncols, const Scalar *w, Scalar *h)
+    {
+        MapConstMat Vs(V, n, ncols);
+        MapConstVec x(w, n);
+        MapVec res(h, ncols);
+        res.noalias() = Vs.transpose() * x;
+    }
+
+    ///
+    /// Residual of the projection: \f$f=w-V(:,0\ldots ncols-1)h\f$.
+    ///
+    void residual(const Scalar *V, int n, int ncols, const Scalar *w,
+                  const Scalar *h, Scalar *f)
+    {
+        MapConstMat Vs(V, n, ncols);
+        MapConstVec x(w, n);
+        MapConstVec c(h, ncols);
+        MapVec res(f, n);
+        res.noalias() = x - Vs * c;
+    }
+
+    ///
+    /// Reorthogonalization correction: \f$f=f-V(:,0\ldots ncols-1)h\f$.
+    ///
+    void correct(const Scalar *V, int n, int ncols, const Scalar *h, Scalar *f)
+    {
+        MapConstMat Vs(V, n, ncols);
+        MapConstVec c(h, ncols);
+        MapVec res(f, n);
+        res.noalias() -= Vs * c;
+    }
+};
+
+
+#endif // BASIS_GEMV_H
@@ -0,0 +1,348 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BATCH_SYM_EIGS_SOLVER_H
+#define BATCH_SYM_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <vector>     // std::vector
+#include <algorithm>  // std::min, std::max
+#include <stdexcept>  // std::invalid_argument, std::logic_error
+
+#include "SymEigsSolver.h"
+#include "MatOp/DenseGenMatProd.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a batch driver that computes the eigen pairs of
+/// many independent small eigen problems in one call. It takes an array
+/// of matrix operation objects and schedules them across a thread pool,
+/// one problem per task. Each thread owns a preallocated basis arena that
+/// is handed to the per-problem solvers through the external-buffer
+/// constructor of SymEigsSolver, so the largest allocation of a solve is
+/// made once per thread instead of once per problem, and no two threads
+/// ever share a heap block. The results are written into packed
+/// column-major arrays — all eigenvalues in one `nev x nbatch` matrix,
+/// all eigenvectors in one contiguous buffer with cache-line aligned
+/// per-problem slices — through the caller-buffer retrieval methods of
+/// the solver, so nothing is copied twice and concurrent writes never
+/// touch the same cache line.
+///
+/// The initial residual of every problem is generated from a small
+/// problem-indexed pseudo-random recurrence rather than from `rand()`,
+/// so the computation is deterministic and free of data races regardless
+/// of the thread schedule.
+///
+/// If the compiler does not support OpenMP, the problems are solved
+/// serially and the results are identical.
+///
+/// \tparam Scalar        The element type of the matrices.
+///                       Currently supported types are `float`, `double` and `long double`.
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the requested eigenvalues, applied to every problem
+///                       of the batch. The full list of enumeration values can
+///                       be found in SelectionRule.h .
+/// \tparam OpType        The name of the matrix operation class, e.g.
+///                       DenseGenMatProd, shared by all problems of the batch.
+///
+template < typename Scalar = double,
+           int SelectionRule = LARGEST_MAGN,
+           typename OpType = DenseGenMatProd<double> >
+class BatchSymEigsSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<const Matrix> MapMat;
+    typedef Eigen::Map<const Vector> MapVec;
+
+    OpType **ops;        // array of matrix operation objects, one per problem
+    const int nbatch;    // number of problems in the batch
+    const int nev;       // number of eigenvalues requested from each problem
+    const int ncv;       // subspace size, clamped per problem to its dimension
+    int nthread;         // number of threads used by compute()
+
+    // Number of scalars per cache line; per-problem slices of the packed
+    // buffers are rounded up to this, so that threads finishing adjacent
+    // problems never write to the same line
+    static const int line_pad = 64 / sizeof(Scalar);
+
+    std::vector<int> prob_n;          // dimension of each problem
+    std::vector<long> vec_offset;     // start of each problem's slice in
+                                      // the packed eigenvector buffer
+    std::vector<int> batch_nconv;     // converged eigenvalues per problem
+    std::vector<int> batch_niter;     // iterations used per problem
+    std::vector<int> batch_nops;      // matrix operations per problem
+
+    Matrix batch_val;    // packed eigenvalues, nev x nbatch
+    Vector batch_vec;    // packed eigenvectors
+    Vector arena;        // per-thread basis buffers, nthread slices
+
+    bool computed;
+
+    // Deterministic problem-indexed initial residual in (-0.5, 0.5),
+    // using a linear congruential recurrence so that no global random
+    // state is touched from inside the parallel region
+    static void fill_init_resid(Vector &resid, int prob_ind)
+    {
+        unsigned long state = 6364136223846793005UL * (unsigned long)(prob_ind + 1)
+                              + 1442695040888963407UL;
+        const int n = resid.size();
+        for(int i = 0; i < n; i++)
+        {
+            state = 6364136223846793005UL * state + 1442695040888963407UL;
+            resid[i] = Scalar(state >> 11) / Scalar(9007199254740992.0) - Scalar(0.5);
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create a batch solver object.
+    ///
+    /// \param ops_     Array of `nbatch_` pointers to matrix operation
+    ///                 objects, one per problem. The problems may have
+    ///                 different dimensions.
+    /// \param nbatch_  Number of problems in the batch.
+    /// \param nev_     Number of eigenvalues requested from each problem.
+    ///                 This should satisfy \f$1\le nev \le n_j-1\f$ for every
+    ///                 problem dimension \f$n_j\f$.
+    /// \param ncv_     Parameter that controls the convergence speed of the
+    ///                 algorithm, passed to each per-problem solver and
+    ///                 clamped to the problem dimension. This parameter must
+    ///                 satisfy \f$ncv > nev\f$, and is advised to take
+    ///                 \f$ncv \ge 2\cdot nev\f$.
+    /// \param nthread_ Number of threads to use. The default value zero means
+    ///                 using all the threads the OpenMP runtime provides.
+    ///
+    BatchSymEigsSolver(OpType **ops_, int nbatch_, int nev_, int ncv_, int nthread_ = 0) :
+        ops(ops_),
+        nbatch(nbatch_),
+        nev(nev_),
+        ncv(ncv_),
+        nthread(nthread_),
+        computed(false)
+    {
+        if(nbatch < 1)
+            throw std::invalid_argument("BatchSymEigsSolver: batch must contain at least one problem");
+        if(ncv_ <= nev_)
+            throw std::invalid_argument("BatchSymEigsSolver: ncv must satisfy nev < ncv");
+
+        // Validate every problem here, since throwing from inside the
+        // parallel region of compute() is not an option
+        prob_n.resize(nbatch);
+        vec_offset.resize(nbatch + 1);
+        long offset = 0;
+        for(int j = 0; j < nbatch; j++)
+        {
+            const int n = ops[j]->rows();
+            if(nev_ < 1 || nev_ > n - 1)
+                throw std::invalid_argument("BatchSymEigsSolver: nev must satisfy 1 <= nev <= n - 1 for every problem in the batch");
+            prob_n[j] = n;
+            vec_offset[j] = offset;
+            // Cache-line aligned slice of n * nev scalars
+            offset += ((long(n) * nev + line_pad - 1) / line_pad) * line_pad;
+        }
+        vec_offset[nbatch] = offset;
+
+#ifdef _OPENMP
+        if(nthread < 1)
+            nthread = omp_get_max_threads();
+#else
+        nthread = 1;
+#endif
+        if(nthread < 1)
+            nthread = 1;
+        nthread = std::min(nthread, nbatch);
+    }
+
+    ///
+    /// Return the number of threads used by compute().
+    ///
+    int num_threads() { return nthread; }
+
+    ///
+    /// Solving all the problems of the batch.
+    ///
+    /// \param maxit Maximum number of iterations allowed for each problem.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of problems whose `nev` requested eigenvalues all
+    ///         converged. Per-problem counts are available through
+    ///         num_converged().
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        batch_nconv.assign(nbatch, 0);
+        batch_niter.assign(nbatch, 0);
+        batch_nops.assign(nbatch, 0);
+        batch_val.resize(nev, nbatch);
+        batch_val.setZero();
+        batch_vec.resize(vec_offset[nbatch]);
+        batch_vec.setZero();
+
+        // One basis arena slice per thread, sized for the largest problem
+        // and aligned to cache lines, reused by every problem the thread
+        // picks up
+        int max_n = 0;
+        for(int j = 0; j < nbatch; j++)
+            max_n = std::max(max_n, prob_n[j]);
+        const long arena_stride = ((long(max_n) * ncv + line_pad - 1) / line_pad) * line_pad;
+        arena.resize(arena_stride * nthread);
+
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        #endif
+        for(int j = 0; j < nbatch; j++)
+        {
+            int tid = 0;
+            #ifdef _OPENMP
+            tid = omp_get_thread_num();
+            #endif
+            Scalar *basis = &arena[tid * arena_stride];
+
+            // Clamp the subspace size to the problem dimension, as
+            // promised in the class doc; the per-problem solver would
+            // otherwise throw for ncv > n_j, which inside this parallel
+            // region would terminate the program. The clamped value is
+            // always valid: ncv > nev and n_j > nev were both checked in
+            // the constructor.
+            const int ncv_j = std::min(ncv, prob_n[j]);
+            SymEigsSolver<Scalar, SelectionRule, OpType> eigs(ops[j], nev, ncv_j, basis);
+
+            Vector resid(prob_n[j]);
+            fill_init_resid(resid, j);
+            eigs.init(resid.data());
+
+            const int nconv = eigs.compute(maxit, tol);
+            batch_nconv[j] = nconv;
+            batch_niter[j] = eigs.num_iterations();
+            batch_nops[j] = eigs.num_operations();
+            // Write the results straight into the packed output slices
+            eigs.eigenvalues(&batch_val(0, j));
+            eigs.eigenvectors(&batch_vec[vec_offset[j]], nconv);
+        }
+
+        computed = true;
+
+        int nfull = 0;
+        for(int j = 0; j < nbatch; j++)
+            nfull += (batch_nconv[j] >= nev);
+        return nfull;
+    }
+
+    ///
+    /// Returning the number of converged eigenvalues of one problem.
+    ///
+    /// \param prob_ind Index of the problem in the batch.
+    ///
+    int num_converged(int prob_ind)
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        return batch_nconv[prob_ind];
+    }
+
+    ///
+    /// Returning the total number of iterations used over the whole batch.
+    ///
+    int num_iterations()
+    {
+        int total = 0;
+        for(int j = 0; j < (int)batch_niter.size(); j++)
+            total += batch_niter[j];
+        return total;
+    }
+
+    ///
+    /// Returning the total number of matrix operations used over the whole batch.
+    ///
+    int num_operations()
+    {
+        int total = 0;
+        for(int j = 0; j < (int)batch_nops.size(); j++)
+            total += batch_nops[j];
+        return total;
+    }
+
+    ///
+    /// Returning the packed eigenvalues of the whole batch as an
+    /// `nev x nbatch` matrix, one column per problem. Columns of problems
+    /// with fewer than `nev` converged values are padded with zeros after
+    /// their num_converged() entries.
+    ///
+    const Matrix & eigenvalues()
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        return batch_val;
+    }
+
+    ///
+    /// Returning the converged eigenvalues of one problem.
+    ///
+    /// \param prob_ind Index of the problem in the batch.
+    ///
+    Vector eigenvalues(int prob_ind)
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        return batch_val.col(prob_ind).head(batch_nconv[prob_ind]);
+    }
+
+    ///
+    /// Returning the eigenvectors of one problem, one column per converged
+    /// eigenvalue.
+    ///
+    /// \param prob_ind Index of the problem in the batch.
+    ///
+    Matrix eigenvectors(int prob_ind)
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        MapMat slice(&batch_vec[vec_offset[prob_ind]], prob_n[prob_ind], batch_nconv[prob_ind]);
+        return slice;
+    }
+
+    ///
+    /// Returning a pointer to the packed eigenvalue storage, which holds
+    /// the `nev x nbatch` matrix of eigenvalues() in column-major order.
+    ///
+    const Scalar * eigenvalues_data()
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        return batch_val.data();
+    }
+
+    ///
+    /// Returning a pointer to one problem's slice of the packed
+    /// eigenvector buffer, holding an \f$n_j \times nconv_j\f$ matrix in
+    /// column-major order. Slices are laid out in problem order and start
+    /// at cache-line boundaries.
+    ///
+    /// \param prob_ind Index of the problem in the batch.
+    ///
+    const Scalar * eigenvectors_data(int prob_ind)
+    {
+        if(!computed)
+            throw std::logic_error("BatchSymEigsSolver: need to call compute() first");
+
+        return &batch_vec[vec_offset[prob_ind]];
+    }
+};
+
+
+#endif // BATCH_SYM_EIGS_SOLVER_H
@@ -14,7 +14,10 @@
 #include <limits>     // std::numeric_limits
 #include <stdexcept>  // std::invalid_argument, std::logic_error
 
-template <typename Scalar = double>
+// The optional MaxNcv template parameter puts a compile-time bound on the
+// matrix size, turning the internal storage into fixed-capacity objects
+// whose per-compute() resizes never touch the heap; see UpperHessenbergQR
+template <typename Scalar = double, int MaxNcv = Eigen::Dynamic>
 class DoubleShiftQR
 {
 private:
@@ -25,11 +28,16 @@ private:
     typedef Eigen::Ref<Matrix> GenericMatrix;
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
 
-    int n;              // Dimension of the matrix
-    Matrix mat_H;       // A copy of the matrix to be factorized
-    Scalar shift_s;     // Shift constant
-    Scalar shift_t;     // Shift constant
-    Matrix3X ref_u;     // Householder reflectors
+    // Fixed-capacity storage types, identical to the dynamic ones when
+    // MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxNcv, MaxNcv> StorageMatrix;
+    typedef Eigen::Matrix<Scalar, 3, Eigen::Dynamic, Eigen::ColMajor, 3, MaxNcv> StorageMatrix3X;
+
+    int n;                   // Dimension of the matrix
+    StorageMatrix mat_H;     // A copy of the matrix to be factorized
+    Scalar shift_s;          // Shift constant
+    Scalar shift_t;          // Shift constant
+    StorageMatrix3X ref_u;   // Householder reflectors
     const Scalar prec;  // Approximately zero
     const Scalar eps_rel;
     const Scalar eps_abs;
@@ -169,7 +177,9 @@ private:
     }
 
     // XP = X - 2 * (X * u) * u'
-    void apply_XP(GenericMatrix X, int stride, int u_ind)
+    // X0 points to the first column that the reflector touches, and the
+    // update is restricted to nrow rows starting from that pointer
+    void apply_XP(Scalar *X0, int stride, int nrow, int ncol, int u_ind)
     {
         Scalar *u = ref_u.data() + 3 * u_ind;
         Scalar u2_abs = std::abs(u[2]);
@@ -177,11 +187,9 @@ private:
         if(std::abs(u[0]) + std::abs(u[1]) + u2_abs <= 3 * prec)
             return;
 
-        const int nrow = X.rows();
-        const int ncol = X.cols();
         const Scalar u0_2 = 2 * u[0];
         const Scalar u1_2 = 2 * u[1];
-        Scalar *X0 = X.data(), *X1 = X0 + stride;  // X0 => X.col(0), X1 => X.col(1)
+        Scalar *X1 = X0 + stride;  // X1 => second column
 
         if(u2_abs <= prec || ncol == 2)
         {
@@ -195,7 +203,7 @@ private:
                 X1[i] -= tmp * u[1];
             }
         } else {
-            Scalar *X2 = X1 + stride;  // X2 => X.col(2)
+            Scalar *X2 = X1 + stride;  // X2 => third column
             const Scalar u2_2 = 2 * u[2];
             for(int i = 0; i < nrow; i++)
             {
@@ -207,6 +215,11 @@ private:
         }
     }
 
+    void apply_XP(GenericMatrix X, int stride, int u_ind)
+    {
+        apply_XP(X.data(), stride, X.rows(), X.cols(), u_ind);
+    }
+
 public:
     DoubleShiftQR(int size) :
         n(size),
@@ -234,6 +247,8 @@ public:
     {
         if(mat.rows() != mat.cols())
             throw std::invalid_argument("DoubleShiftQR: matrix must be square");
+        if(MaxNcv != Eigen::Dynamic && mat.rows() > MaxNcv)
+            throw std::invalid_argument("DoubleShiftQR: matrix size exceeds the MaxNcv template parameter");
 
         n = mat.rows();
         mat_H.resize(n, n);
@@ -300,6 +315,16 @@ public:
         return mat_H;
     }
 
+    // Overwrite dest with Q'HQ. This overload writes into an existing
+    // matrix of the proper size, so repeated calls do not allocate memory.
+    void matrix_QtHQ(GenericMatrix dest)
+    {
+        if(!computed)
+            throw std::logic_error("DoubleShiftQR: need to call compute() first");
+
+        dest.noalias() = mat_H;
+    }
+
     // Q = P0 * P1 * ...
     // Q'y = P_{n-2} * ... * P1 * P0 * y
     void apply_QtY(Vector &y)
@@ -321,12 +346,26 @@ public:
         if(!computed)
             throw std::logic_error("DoubleShiftQR: need to call compute() first");
 
-        int nrow = Y.rows();
-        for(int i = 0; i < n - 2; i++)
+        // Applying the reflectors one by one to the full column height
+        // streams the whole of Y through the cache once per reflector.
+        // Instead, the reflector sweep is fused over blocks of rows:
+        // consecutive reflectors overlap in the columns they touch, so
+        // sweeping all of them over one block of rows reuses the block
+        // while it is still in cache, and the arithmetic is unchanged
+        // since the reflectors never mix different rows of Y.
+        const int nrow = Y.rows();
+        const int stride = Y.outerStride();
+        const int block_rows = 64;
+        for(int r = 0; r < nrow; r += block_rows)
         {
-            apply_XP(Y.block(0, i, nrow, 3), nrow, i);
+            const int rb = std::min(block_rows, nrow - r);
+            Scalar *Yr = Y.data() + r;
+            for(int i = 0; i < n - 2; i++)
+            {
+                apply_XP(Yr + i * stride, stride, rb, 3, i);
+            }
+            apply_XP(Yr + (n - 2) * stride, stride, rb, 2, n - 2);
         }
-        apply_XP(Y.block(0, n - 2, nrow, 2), nrow, n - 2);
     }
 };
 
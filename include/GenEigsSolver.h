@@ -13,9 +13,13 @@
 #include <algorithm>  // std::min, std::copy
 #include <complex>    // std::complex, std::conj, std::norm
 #include <limits>     // std::numeric_limits
+#include <new>        // placement new for re-mapping fac_V
 #include <stdexcept>  // std::invalid_argument
 
 #include "SelectionRule.h"
+#include "ReorthRule.h"
+#include "SolverStats.h"
+#include "BasisGemv.h"
 #include "UpperHessenbergQR.h"
 #include "UpperHessenbergEigen.h"
 #include "DoubleShiftQR.h"
@@ -44,6 +48,25 @@
 ///                       use the DenseGenMatProd wrapper class, or define their
 ///                       own that impelemnts all the public member functions as in
 ///                       DenseGenMatProd.
+/// \tparam StatsPolicy   The statistics policy class. The default NullSolverStats
+///                       compiles all instrumentation out; passing SolverStats
+///                       instead makes the solver record per-phase wall time and
+///                       event counts, accessible through the stats() member.
+/// \tparam GemvPolicy    The policy class performing the matrix-vector products
+///                       against the basis \f$V\f$ inside the Arnoldi
+///                       factorization. The default HostBasisGemv runs them on
+///                       the host through **Eigen**; a custom policy can run
+///                       them wherever the basis buffer lives, see HostBasisGemv.
+/// \tparam MaxNcv        Optional compile-time upper bound on `ncv`. When a
+///                       deployment uses a small constant subspace size, passing
+///                       it here turns the internal storage of the dense
+///                       \f$ncv\times ncv\f$ subproblems (UpperHessenbergQR,
+///                       DoubleShiftQR and UpperHessenbergEigen) into
+///                       fixed-capacity objects: the per-restart temporaries
+///                       live inline instead of on the heap, which is
+///                       worthwhile in streaming workloads that solve many
+///                       small problems. The default `Eigen::Dynamic` keeps
+///                       the dynamic-size behavior.
 ///
 /// An example that illustrates the usage of GenEigsSolver is give below:
 ///
@@ -81,7 +104,10 @@
 ///
 template < typename Scalar = double,
            int SelectionRule = LARGEST_MAGN,
-           typename OpType = DenseGenMatProd<double> >
+           typename OpType = DenseGenMatProd<double>,
+           typename StatsPolicy = NullSolverStats<Scalar>,
+           typename GemvPolicy = HostBasisGemv<Scalar>,
+           int MaxNcv = Eigen::Dynamic >
 class GenEigsSolver
 {
 private:
@@ -96,6 +122,10 @@ private:
     typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic> ComplexMatrix;
     typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1> ComplexVector;
 
+    // The storage type of the ncv-sized decomposition results; identical
+    // to the dynamic type when MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> SmallComplexVector;
+
 protected:
     OpType *op;             // object to conduct matrix operation,
                             // e.g. matrix-vector product
@@ -103,12 +133,24 @@ protected:
     const int nev;          // number of eigenvalues requested
 
 private:
-    const int ncv;          // number of ritz values
+    int ncv;                // number of ritz values; changes between the
+                            // restarts when adaptive tuning is enabled
+    int ncv_min;            // lower bound of ncv for the adaptive tuning
+    int ncv_max;            // upper bound of ncv; zero disables the tuning
+    int adapt_window;       // number of restarts observed before adapting
+    int ncv_next;           // subspace size to switch to at the next restart
+    int adapt_last;         // nconv observed at the previous restart
+    int adapt_stall;        // consecutive restarts without a new converged pair
+    int adapt_fast;         // consecutive restarts each converging a new pair
     int nmatop;             // number of matrix operations called
     int niter;              // number of restarting iterations
 
 protected:
-    Matrix fac_V;           // V matrix in the Arnoldi factorization
+    Matrix fac_V_data;      // in-RAM storage of the V matrix, used when no
+                            // external basis buffer is provided
+    Scalar *basis_ptr;      // external buffer holding the V matrix, e.g. a
+                            // memory-mapped file (NULL for in-RAM storage)
+    MapMat fac_V;           // V matrix in the Arnoldi factorization
     Matrix fac_H;           // H matrix in the Arnoldi factorization
     Vector fac_f;           // residual in the Arnoldi factorization
 
@@ -116,6 +158,9 @@ protected:
     ComplexMatrix ritz_vec; // ritz vectors
 
 private:
+    ComplexVector ritz_est; // last row of the eigenvector matrix of fac_H,
+                            // used to estimate residuals during the restart
+                            // iterations without computing full Ritz vectors
     BoolArray ritz_conv;    // indicator of the convergence of ritz values
 
     const Scalar prec;      // precision parameter used to test convergence
@@ -123,6 +168,42 @@ private:
                             // epsilon is the machine precision,
                             // e.g. ~= 1e-16 for the "double" type
 
+    int reorth_rule;        // reorthogonalization strategy, one of the
+                            // REORTH_* enumeration values
+
+    int stop_minconv;    // early-exit threshold of the stopping rule;
+                         // 0 means iterate until all nev have converged
+    double stop_maxtime; // wall-clock budget in seconds; 0 means unlimited
+    Vector stop_tol;     // per-Ritz-position tolerances; an empty vector
+                         // means the uniform tol argument of compute()
+    // Per-restart callback and its opaque user data; returning false
+    // from the callback aborts the iterations
+    bool (*stop_callback)(int iter, int nconv, const Complex *ritz_val,
+                          const Scalar *resid_est, int nvals, void *data);
+    void *stop_callback_data;
+
+    // Preallocated workspace, sized once in init(), so that the hot-path
+    // routines below do not touch the heap during the iterations
+    Vector ws_w;               // length-n scratch to receive perform_op() results
+    Vector ws_Vf;              // coefficients in the reorthogonalization step
+    Vector ws_fk;              // new residual vector computed in restart()
+    Vector ws_resid;           // residual estimates passed to the callback
+    Matrix ws_Q;               // accumulated rotation matrix in restart()
+    Matrix ws_Vs;              // new basis columns computed in restart()
+    DoubleShiftQR<Scalar, MaxNcv> ws_decomp_ds;         // QR decompositions reused
+    UpperHessenbergQR<Scalar, MaxNcv> ws_decomp_hb;     // for all shifts
+    UpperHessenbergEigen<Scalar, MaxNcv> ws_eig;        // eigen decomposition of fac_H,
+                                                // reused across the restarts
+    SortEigenvalue<Complex, SelectionRule> ws_sort;  // sorting machinery,
+                                                     // reused across the restarts
+    std::vector<int> ws_ind;   // order index of the Ritz values
+    ComplexVector ws_cv;       // complex scratch column used in sort_ritzpair()
+
+    StatsPolicy stats_rec;     // per-phase statistics, a no-op recorder
+                               // by default
+    GemvPolicy gemv_impl;      // performs the products against the basis
+                               // in factorize_from()
+
     // Arnoldi factorization starting from step-k
     void factorize_from(int from_k, int to_m, const Vector &fk)
     {
@@ -130,7 +211,6 @@ private:
 
         fac_f = fk;
 
-        Vector w(dim_n);
         Scalar beta = 0.0;
         // Keep the upperleft k x k submatrix of H and set other elements to 0
         fac_H.rightCols(ncv - from_k).setZero();
@@ -142,16 +222,65 @@ private:
             fac_H(i, i - 1) = beta;
 
             // w = A * v, v = fac_V.col(i)
-            op->perform_op(&fac_V(0, i), w.data());
+            // For the default NullSolverStats policy, wall_time() is an
+            // inline constant and the add_*() calls are empty, so the
+            // timing code below disappears at compile time
+            double t_op = StatsPolicy::wall_time();
+            op->perform_op(&fac_V(0, i), ws_w.data());
             nmatop++;
+            stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
+
+            // h = fac_H(0:i, i) = V(:, 0:i)' * w, and f = w - V(:, 0:i) * h
+            // The large products against the basis go through the
+            // GemvPolicy, so that the basis may live in memory the solver
+            // does not compute on directly; see HostBasisGemv
+            gemv_impl.project(fac_V.data(), dim_n, i + 1, ws_w.data(), &fac_H(0, i));
+            gemv_impl.residual(fac_V.data(), dim_n, i + 1, ws_w.data(), &fac_H(0, i), fac_f.data());
+            reorthogonalize(i + 1);
+        }
+    }
+
+    // One classical Gram-Schmidt correction pass of fac_f against the
+    // first ncols basis columns, routed through the GemvPolicy as a pair
+    // of passes over a contiguous column panel of fac_V
+    void reorth_pass(int ncols)
+    {
+        gemv_impl.project(fac_V.data(), dim_n, ncols, fac_f.data(), ws_Vf.data());
+        gemv_impl.correct(fac_V.data(), dim_n, ncols, ws_Vf.data(), fac_f.data());
+    }
 
-            // First i+1 columns of V
-            MapMat Vs(fac_V.data(), dim_n, i + 1);
-            // h = fac_H(0:i, i)
-            MapVec h(&fac_H(0, i), i + 1);
-            h.noalias() = Vs.transpose() * w;
+    // Orthogonality maintenance of fac_f against the first ncols basis
+    // columns, following the strategy selected by reorth_rule
+    void reorthogonalize(int ncols)
+    {
+        if(reorth_rule == REORTH_NONE)
+            return;
 
-            fac_f = w - Vs * h;
+        double t_re = StatsPolicy::wall_time();
+        if(reorth_rule == REORTH_FULL)
+        {
+            stats_rec.reorth_hit();
+            reorth_pass(ncols);
+        }
+        else if(reorth_rule == REORTH_DGKS)
+        {
+            // Iterated CGS with the eta test of Daniel, Gragg, Kaufman
+            // and Stewart: a correction pass is needed whenever the new
+            // residual is much shorter than the vector it was computed
+            // from, and is repeated while that keeps being the case
+            const Scalar eta = Scalar(1) / std::sqrt(Scalar(2));
+            Scalar last = ws_w.norm();
+            Scalar fnorm = fac_f.norm();
+            for(int pass = 0; pass < 3 && fnorm < eta * last; pass++)
+            {
+                stats_rec.reorth_hit();
+                reorth_pass(ncols);
+                last = fnorm;
+                fnorm = fac_f.norm();
+            }
+        }
+        else  // REORTH_STANDARD
+        {
             // Correct f if it is not orthogonal to V
             // Typically the largest absolute value occurs in
             // the first element, i.e., <v1, f>, so we use this
@@ -159,12 +288,13 @@ private:
             Scalar v1f = fac_f.dot(fac_V.col(0));
             if(v1f > prec || v1f < -prec)
             {
-                Vector Vf(i + 1);
-                Vf.tail(i) = fac_V.block(0, 1, dim_n, i).transpose() * fac_f;
-                Vf[0] = v1f;
-                fac_f -= Vs * Vf;
+                gemv_impl.project(fac_V.data() + dim_n, dim_n, ncols - 1, fac_f.data(), ws_Vf.data() + 1);
+                ws_Vf[0] = v1f;
+                gemv_impl.correct(fac_V.data(), dim_n, ncols, ws_Vf.data(), fac_f.data());
+                stats_rec.reorth_hit();
             }
         }
+        stats_rec.add_reorth_time(StatsPolicy::wall_time() - t_re);
     }
 
     static bool is_complex(Complex v, Scalar eps)
@@ -183,9 +313,9 @@ private:
         if(k >= ncv)
             return;
 
-        DoubleShiftQR<Scalar> decomp_ds(ncv);
-        UpperHessenbergQR<Scalar> decomp_hb;
-        Matrix Q = Matrix::Identity(ncv, ncv);
+        ws_Q.setIdentity();
+
+        double t_rs = StatsPolicy::wall_time();
 
         for(int i = k; i < ncv; i++)
         {
@@ -200,55 +330,60 @@ private:
                 Scalar s = 2 * ritz_val[i].real();
                 Scalar t = std::norm(ritz_val[i]);
 
-                decomp_ds.compute(fac_H, s, t);
+                ws_decomp_ds.compute(fac_H, s, t);
 
                 // Q -> Q * Qi
-                decomp_ds.apply_YQ(Q);
+                ws_decomp_ds.apply_YQ(ws_Q);
                 // H -> Q'HQ
-                // Matrix Q = Matrix::Identity(ncv, ncv);
-                // decomp_ds.apply_YQ(Q);
-                // fac_H = Q.transpose() * fac_H * Q;
-                fac_H = decomp_ds.matrix_QtHQ();
+                ws_decomp_ds.matrix_QtHQ(fac_H);
 
                 i++;
             } else {
                 // QR decomposition of H - mu * I, mu is real
                 fac_H.diagonal().array() -= ritz_val[i].real();
-                decomp_hb.compute(fac_H);
+                ws_decomp_hb.compute(fac_H);
 
                 // Q -> Q * Qi
-                decomp_hb.apply_YQ(Q);
+                ws_decomp_hb.apply_YQ(ws_Q);
                 // H -> Q'HQ = RQ + mu * I
-                fac_H = decomp_hb.matrix_RQ();
+                ws_decomp_hb.matrix_RQ(fac_H);
                 fac_H.diagonal().array() += ritz_val[i].real();
             }
         }
         // V -> VQ, only need to update the first k+1 columns
-        // Q has some elements being zero
-        // The first (ncv - k + i) elements of the i-th column of Q are non-zero
-        Matrix Vs(dim_n, k + 1);
-        int nnz;
-        for(int i = 0; i < k; i++)
-        {
-            nnz = ncv - k + i + 1;
-            MapMat V(fac_V.data(), dim_n, nnz);
-            MapVec q(&Q(0, i), nnz);
-            Vs.col(i).noalias() = V * q;
-        }
-        Vs.col(k).noalias() = fac_V * Q.col(k);
-        fac_V.leftCols(k + 1).noalias() = Vs;
-
-        Vector fk = fac_f * Q(ncv - 1, k - 1) + fac_V.col(k) * fac_H(k, k - 1);
-        factorize_from(k, ncv, fk);
-        retrieve_ritzpair();
+        // Q has some zero elements in its lower-left corner, but exploiting
+        // them column by column would turn this update into a sequence of
+        // matrix-vector products; a single matrix-matrix product wastes a
+        // fraction of the flops on those zeros and still runs much faster,
+        // since it goes through the blocked level-3 kernels
+        ws_Vs.leftCols(k + 1).noalias() = fac_V * ws_Q.leftCols(k + 1);
+        fac_V.leftCols(k + 1).noalias() = ws_Vs.leftCols(k + 1);
+
+        stats_rec.restart_hit();
+        stats_rec.add_restart_time(StatsPolicy::wall_time() - t_rs);
+
+        ws_fk.noalias() = fac_f * ws_Q(ncv - 1, k - 1) + fac_V.col(k) * fac_H(k, k - 1);
+        // The factorization has just been compressed to k columns, which
+        // is the only point where the subspace size can change cheaply
+        if(ncv_next != ncv)
+            resize_subspace(std::max(ncv_next, k + 2));
+        factorize_from(k, ncv, ws_fk);
+        // Full Ritz vectors are not needed inside the iterations
+        retrieve_ritzpair(false);
     }
 
     // Calculate the number of converged Ritz values
     int num_converged(Scalar tol)
     {
         // thresh = tol * max(prec, abs(theta)), theta for ritz value
-        Array thresh = tol * ritz_val.head(nev).array().abs().max(prec);
-        Array resid = ritz_vec.template bottomRows<1>().transpose().array().abs() * fac_f.norm();
+        // With per-position tolerances installed, each wanted Ritz pair
+        // is tested against its own tol instead of the uniform one
+        Array thresh(nev);
+        if(stop_tol.size() == nev)
+            thresh = stop_tol.array() * ritz_val.head(nev).array().abs().max(prec);
+        else
+            thresh = tol * ritz_val.head(nev).array().abs().max(prec);
+        Array resid = ritz_est.head(nev).array().abs() * fac_f.norm();
         // Converged "wanted" ritz values
         ritz_conv = (resid < thresh);
 
@@ -287,25 +422,109 @@ private:
         return nev_new;
     }
 
-    // Retrieve and sort ritz values and ritz vectors
-    void retrieve_ritzpair()
+    // Update the adaptive subspace size from the convergence progress.
+    // A window of restarts without any new converged pair means the
+    // subspace is too small to hold the wanted eigenvectors, while a
+    // window where every restart converges a new one means it is larger
+    // than needed. The growth is geometric, so the total resizing work
+    // stays amortized over the restarts that triggered it.
+    void tune_ncv(int nconv)
     {
-        UpperHessenbergEigen<Scalar> decomp(fac_H);
-        ComplexVector evals = decomp.eigenvalues();
-        ComplexMatrix evecs = decomp.eigenvectors();
+        if(ncv_max <= 0)
+            return;
 
-        SortEigenvalue<Complex, SelectionRule> sorting(evals.data(), evals.size());
-        std::vector<int> ind = sorting.index();
+        if(nconv > adapt_last)
+        {
+            adapt_stall = 0;
+            adapt_fast++;
+        } else {
+            adapt_stall++;
+            adapt_fast = 0;
+        }
+        adapt_last = nconv;
+
+        if(adapt_stall >= adapt_window && ncv < ncv_max)
+        {
+            ncv_next = std::min(ncv_max, ncv + ncv / 2 + 1);
+            adapt_stall = 0;
+        }
+        else if(adapt_fast >= adapt_window && ncv > ncv_min)
+        {
+            ncv_next = std::max(ncv_min, ncv - ncv / 4);
+            adapt_fast = 0;
+        }
+    }
+
+    // Move the factorization storage to a subspace of newncv columns.
+    // Only the leading basis columns and the top-left corner of H survive
+    // the compression in restart(), and the conservative resizes below
+    // preserve exactly the leading parts. This runs only between the
+    // restarts, so the factorization steps themselves stay allocation-free.
+    void resize_subspace(int newncv)
+    {
+        if(newncv > dim_n)
+            newncv = dim_n;
+        if(newncv == ncv)
+        {
+            ncv_next = ncv;
+            return;
+        }
+
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, newncv);
+        else
+        {
+            fac_V_data.conservativeResize(dim_n, newncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, newncv);
+        }
+        fac_H.conservativeResize(newncv, newncv);
+        ritz_val.conservativeResize(newncv);
+        ritz_est.conservativeResize(newncv);
+        ritz_vec.resize(newncv, nev);
+        ws_Vf.resize(newncv);
+        ws_Q.resize(newncv, newncv);
+        ws_Vs.resize(dim_n, newncv);
+        ws_ind.resize(newncv);
+        ws_cv.resize(newncv);
+
+        ncv = newncv;
+        ncv_next = newncv;
+    }
+
+    // Retrieve and sort ritz values and ritz vectors
+    // When compute_vecs is false, only the Ritz values and the residual
+    // estimates in ritz_est are updated, which avoids the O(ncv^3)
+    // eigenvector back transformation on every restart
+    void retrieve_ritzpair(bool compute_vecs = true)
+    {
+        double t_rz = StatsPolicy::wall_time();
+        // The decomposition object, the sorting machinery and the index
+        // vector are all preallocated members, so this routine performs
+        // no memory allocation during the restart iterations
+        ws_eig.compute(fac_H, compute_vecs);
+        const SmallComplexVector &evals = ws_eig.eigenvalues();
+        const SmallComplexVector &brow = ws_eig.eigenvectors_bottom_row();
+
+        ws_sort.compute(evals.data(), ncv);
+        int *ind = &ws_ind[0];
+        ws_sort.index(ind);
 
         // Copy the ritz values and vectors to ritz_val and ritz_vec, respectively
         for(int i = 0; i < ncv; i++)
         {
             ritz_val[i] = evals[ind[i]];
+            ritz_est[i] = brow[ind[i]];
         }
-        for(int i = 0; i < nev; i++)
+        if(compute_vecs)
         {
-            ritz_vec.col(i) = evecs.col(ind[i]);
+            ComplexMatrix evecs = ws_eig.eigenvectors();
+            for(int i = 0; i < nev; i++)
+            {
+                ritz_vec.col(i) = evecs.col(ind[i]);
+            }
         }
+
+        stats_rec.add_ritz_time(StatsPolicy::wall_time() - t_rz);
     }
 
 protected:
@@ -314,22 +533,35 @@ protected:
     virtual void sort_ritzpair()
     {
         SortEigenvalue<Complex, LARGEST_MAGN> sorting(ritz_val.data(), nev);
-        std::vector<int> ind = sorting.index();
-
-        ComplexVector new_ritz_val(ncv);
-        ComplexMatrix new_ritz_vec(ncv, nev);
-        BoolArray new_ritz_conv(nev);
+        sorting.index(&ws_ind[0]);
 
+        // Apply the permutation in place by following its cycles, so that
+        // no new containers need to be allocated. ws_cv serves as the
+        // temporary for the eigenvector column being moved.
         for(int i = 0; i < nev; i++)
         {
-            new_ritz_val[i] = ritz_val[ind[i]];
-            new_ritz_vec.col(i) = ritz_vec.col(ind[i]);
-            new_ritz_conv[i] = ritz_conv[ind[i]];
+            if(ws_ind[i] == i)
+                continue;
+
+            Complex val = ritz_val[i];
+            bool conv = ritz_conv[i];
+            ws_cv.noalias() = ritz_vec.col(i);
+            int j = i;
+            for(;;)
+            {
+                const int k = ws_ind[j];
+                ws_ind[j] = j;
+                if(k == i)
+                    break;
+                ritz_val[j] = ritz_val[k];
+                ritz_conv[j] = ritz_conv[k];
+                ritz_vec.col(j) = ritz_vec.col(k);
+                j = k;
+            }
+            ritz_val[j] = val;
+            ritz_conv[j] = conv;
+            ritz_vec.col(j) = ws_cv;
         }
-
-        ritz_val.swap(new_ritz_val);
-        ritz_vec.swap(new_ritz_vec);
-        ritz_conv.swap(new_ritz_conv);
     }
 
 public:
@@ -355,15 +587,78 @@ public:
         dim_n(op->rows()),
         nev(nev_),
         ncv(ncv_ > dim_n ? dim_n : ncv_),
+        ncv_min(0),
+        ncv_max(0),
+        adapt_window(5),
+        ncv_next(ncv),
+        nmatop(0),
+        niter(0),
+        basis_ptr(NULL),
+        fac_V(NULL, 0, 0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD),
+        stop_minconv(0),
+        stop_maxtime(0.0),
+        stop_callback(NULL),
+        stop_callback_data(NULL),
+        ws_decomp_ds(ncv)
+    {
+        if(nev_ < 1 || nev_ > dim_n - 2)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 2, n is the size of matrix");
+
+        if(ncv_ < nev_ + 2 || ncv_ > dim_n)
+            throw std::invalid_argument("ncv must satisfy nev + 2 <= ncv <= n, n is the size of matrix");
+
+        if(MaxNcv != Eigen::Dynamic && ncv > MaxNcv)
+            throw std::invalid_argument("ncv exceeds the MaxNcv template parameter");
+    }
+
+    ///
+    /// Constructor to create a solver object whose Arnoldi basis lives in a
+    /// caller-supplied buffer instead of an internally allocated matrix.
+    /// The buffer may come from a memory-mapped file (see MMapBasisStorage)
+    /// or from a user allocator, which allows solving problems whose
+    /// \f$n\times ncv\f$ basis does not fit in RAM.
+    ///
+    /// \param op_    Pointer to the matrix operation object, see above.
+    /// \param nev_   Number of eigenvalues requested.
+    /// \param ncv_   Parameter that controls the convergence speed, see above.
+    /// \param basis_ Pointer to a buffer of at least \f$n\times ncv\f$
+    ///               scalars holding the basis, in column-major order. It
+    ///               must stay valid for the lifetime of the solver.
+    ///
+    GenEigsSolver(OpType *op_, int nev_, int ncv_, Scalar *basis_) :
+        op(op_),
+        dim_n(op->rows()),
+        nev(nev_),
+        ncv(ncv_ > dim_n ? dim_n : ncv_),
+        ncv_min(0),
+        ncv_max(0),
+        adapt_window(5),
+        ncv_next(ncv),
         nmatop(0),
         niter(0),
-        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3))
+        basis_ptr(basis_),
+        fac_V(NULL, 0, 0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD),
+        stop_minconv(0),
+        stop_maxtime(0.0),
+        stop_callback(NULL),
+        stop_callback_data(NULL),
+        ws_decomp_ds(ncv)
     {
         if(nev_ < 1 || nev_ > dim_n - 2)
             throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 2, n is the size of matrix");
 
         if(ncv_ < nev_ + 2 || ncv_ > dim_n)
             throw std::invalid_argument("ncv must satisfy nev + 2 <= ncv <= n, n is the size of matrix");
+
+        if(MaxNcv != Eigen::Dynamic && ncv > MaxNcv)
+            throw std::invalid_argument("ncv exceeds the MaxNcv template parameter");
+
+        if(basis_ == NULL)
+            throw std::invalid_argument("basis buffer cannot be NULL");
     }
 
     ///
@@ -378,11 +673,20 @@ public:
     void init(const Scalar *init_resid)
     {
         // Reset all matrices/vectors to zero
-        fac_V.resize(dim_n, ncv);
+        // The basis either lives in the caller-supplied buffer or in an
+        // internally allocated matrix
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, ncv);
+        else
+        {
+            fac_V_data.resize(dim_n, ncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, ncv);
+        }
         fac_H.resize(ncv, ncv);
         fac_f.resize(dim_n);
         ritz_val.resize(ncv);
         ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
         ritz_conv.resize(nev);
 
         fac_V.setZero();
@@ -390,8 +694,17 @@ public:
         fac_f.setZero();
         ritz_val.setZero();
         ritz_vec.setZero();
+        ritz_est.setZero();
         ritz_conv.setZero();
 
+        ws_w.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_ind.resize(ncv);
+        ws_cv.resize(ncv);
+
         Vector v(dim_n);
         std::copy(init_resid, init_resid + dim_n, v.data());
         Scalar vnorm = v.norm();
@@ -399,12 +712,18 @@ public:
             throw std::invalid_argument("initial residual vector cannot be zero");
         v /= vnorm;
 
-        Vector w(dim_n);
-        op->perform_op(v.data(), w.data());
+        ncv_next = ncv;
+        adapt_last = 0;
+        adapt_stall = 0;
+        adapt_fast = 0;
+        stats_rec.reset();
+        double t_op = StatsPolicy::wall_time();
+        op->perform_op(v.data(), ws_w.data());
         nmatop++;
+        stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
 
-        fac_H(0, 0) = v.dot(w);
-        fac_f = w - v * fac_H(0, 0);
+        fac_H(0, 0) = v.dot(ws_w);
+        fac_f = ws_w - v * fac_H(0, 0);
         fac_V.col(0) = v;
     }
 
@@ -422,6 +741,27 @@ public:
         init(init_resid.data());
     }
 
+    ///
+    /// Providing a warm-start basis for the algorithm.
+    ///
+    /// \param basis Pointer to a \f$n\times ncols\f$ matrix stored in
+    ///              column-major order, typically the eigenvectors computed
+    ///              from a nearby matrix.
+    /// \param ncols Number of columns of the basis.
+    ///
+    /// The columns are combined into the initial residual vector, so the
+    /// iterations start with no component outside the span of the basis.
+    /// When solving a sequence of slowly-varying matrices, seeding each
+    /// solve with the eigenvectors of the previous one in this way can cut
+    /// the iteration count several-fold.
+    ///
+    void init(const Scalar *basis, int ncols)
+    {
+        MapMat V(const_cast<Scalar *>(basis), dim_n, ncols);
+        Vector v0 = V.rowwise().sum();
+        init(v0.data());
+    }
+
     ///
     /// Conducting the major computation procedure.
     ///
@@ -433,27 +773,148 @@ public:
     int compute(int maxit = 1000, Scalar tol = 1e-10)
     {
         // The m-step Arnoldi factorization
-        factorize_from(1, ncv, fac_f);
-        retrieve_ritzpair();
+        ws_fk = fac_f;
+        factorize_from(1, ncv, ws_fk);
+        niter++;
+
+        return compute_continue(maxit, tol);
+    }
+
+    ///
+    /// Resuming the computation from the current Arnoldi factorization,
+    /// without rebuilding it from the initial residual vector. It can be
+    /// called after compute() has exhausted its iteration allowance, or
+    /// after load_state() has restored a checkpointed factorization, and
+    /// all the progress made before is kept.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute_continue(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        retrieve_ritzpair(false);
+        const double t_start = (stop_maxtime > 0) ? SolverStats<Scalar>::wall_time() : 0.0;
         // Restarting
         int i, nconv = 0, nev_adj;
         for(i = 0; i < maxit; i++)
         {
             nconv = num_converged(tol);
+            // The residual norms below are only computed when a recording
+            // statistics policy is in use
+            if(StatsPolicy::enabled)
+                stats_rec.iteration(niter + i, nconv,
+                    (ritz_est.head(nev).array().abs() * fac_f.norm()).maxCoeff());
+            // User-installed per-restart callback; it can abort the
+            // iterations by returning false
+            bool user_abort = false;
+            if(stop_callback != NULL)
+            {
+                ws_resid = (ritz_est.head(nev).array().abs() * fac_f.norm()).matrix();
+                user_abort = !stop_callback(niter + i, nconv, ritz_val.data(),
+                                            ws_resid.data(), nev, stop_callback_data);
+            }
             if(nconv >= nev)
                 break;
+            if(user_abort)
+                break;
+            // Early-exit stopping rule: enough of the wanted values have
+            // converged, or the wall-clock budget has been used up
+            if(stop_minconv > 0 && nconv >= stop_minconv)
+                break;
+            if(stop_maxtime > 0 && SolverStats<Scalar>::wall_time() - t_start >= stop_maxtime)
+                break;
 
+            tune_ncv(nconv);
             nev_adj = nev_adjusted(nconv);
             restart(nev_adj);
         }
+        // The iterations above only work with Ritz values and residual
+        // estimates; compute the full Ritz vectors once at the end
+        retrieve_ritzpair(true);
+        nconv = num_converged(tol);
         // Sorting results
         sort_ritzpair();
 
-        niter += i + 1;
+        niter += i;
 
         return std::min(nev, nconv);
     }
 
+    ///
+    /// Returning the number of scalars needed by save_state() to checkpoint
+    /// the Arnoldi factorization.
+    ///
+    int state_size() const { return dim_n * ncv + ncv * ncv + dim_n; }
+
+    ///
+    /// Saving the current Arnoldi factorization to a user buffer, so that
+    /// an interrupted solve can later be resumed by load_state() and
+    /// compute_continue(), possibly in another process.
+    ///
+    /// \param buffer Pointer to a buffer of at least state_size() scalars.
+    ///
+    void save_state(Scalar *buffer) const
+    {
+        std::copy(fac_V.data(), fac_V.data() + dim_n * ncv, buffer);
+        buffer += dim_n * ncv;
+        std::copy(fac_H.data(), fac_H.data() + ncv * ncv, buffer);
+        buffer += ncv * ncv;
+        std::copy(fac_f.data(), fac_f.data() + dim_n, buffer);
+    }
+
+    ///
+    /// Restoring an Arnoldi factorization saved by save_state(). The solver
+    /// must have been created with the same operation object dimension and
+    /// the same ncv parameter. Use compute_continue() afterwards to resume
+    /// the computation.
+    ///
+    /// \param buffer Pointer to the buffer filled by save_state().
+    ///
+    void load_state(const Scalar *buffer)
+    {
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, ncv);
+        else
+        {
+            fac_V_data.resize(dim_n, ncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, ncv);
+        }
+        fac_H.resize(ncv, ncv);
+        fac_f.resize(dim_n);
+        ritz_val.resize(ncv);
+        ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
+        ritz_conv.resize(nev);
+
+        ws_w.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_ind.resize(ncv);
+        ws_cv.resize(ncv);
+
+        ritz_val.setZero();
+        ritz_vec.setZero();
+        ritz_est.setZero();
+        ritz_conv.setZero();
+
+        nmatop = 0;
+        niter = 0;
+        ncv_next = ncv;
+        adapt_last = 0;
+        adapt_stall = 0;
+        adapt_fast = 0;
+
+        std::copy(buffer, buffer + dim_n * ncv, fac_V.data());
+        buffer += dim_n * ncv;
+        std::copy(buffer, buffer + ncv * ncv, fac_H.data());
+        buffer += ncv * ncv;
+        std::copy(buffer, buffer + dim_n, fac_f.data());
+    }
+
     ///
     /// Returning the number of iterations used in the computation.
     ///
@@ -464,6 +925,160 @@ public:
     ///
     int num_operations() { return nmatop; }
 
+    ///
+    /// Returning the statistics object of the solver. For the default
+    /// NullSolverStats policy this object records nothing; instantiate the
+    /// solver with SolverStats as the `StatsPolicy` template parameter to
+    /// obtain per-phase wall times, reorthogonalization and restart counts,
+    /// and the per-iteration residual norms. The reference is mutable so
+    /// that a per-iteration callback can be installed before compute().
+    ///
+    StatsPolicy & stats() { return stats_rec; }
+
+    ///
+    /// Selecting the reorthogonalization strategy used in the Arnoldi
+    /// factorization. The full list of enumeration values can be found in
+    /// ReorthRule.h . The default REORTH_STANDARD keeps the behavior of
+    /// earlier versions; REORTH_DGKS is recommended for ill-conditioned
+    /// operators, where the standard test may fail to restore
+    /// orthogonality and cause spurious extra restarts.
+    ///
+    /// \param rule One of the `REORTH_*` enumeration values.
+    ///
+    void set_reorth_rule(int rule) { reorth_rule = rule; }
+
+    ///
+    /// The type of the per-restart callback installed by
+    /// set_iteration_callback(). It receives the iteration number, the
+    /// number of converged Ritz values, pointers to the current `nvals`
+    /// wanted (complex) Ritz values and their residual estimates, and the
+    /// opaque user data pointer. Returning `false` aborts the iterations;
+    /// the pairs converged so far remain available through the usual
+    /// retrieval methods.
+    ///
+    typedef bool (*IterationCallback)(int iter, int nconv, const Complex *ritz_val,
+                                      const Scalar *resid_est, int nvals, void *data);
+
+    ///
+    /// Setting an early-exit stopping rule for compute(). The iterations
+    /// end as soon as `min_conv` of the requested eigenvalues have
+    /// converged, or once `max_time` seconds of wall-clock time have been
+    /// spent, whichever comes first. This is useful when a larger `nev`
+    /// is requested for robustness but only the leading few values are
+    /// actually consumed, or when the solve has a latency budget.
+    ///
+    /// \param min_conv Number of converged eigenvalues that is good
+    ///                 enough to stop, `0 <= min_conv <= nev`. Zero (the
+    ///                 default) disables the rule and iterates until all
+    ///                 `nev` have converged.
+    /// \param max_time Wall-clock budget in seconds, checked once per
+    ///                 restart. Zero (the default) means unlimited.
+    ///
+    void set_stop_rule(int min_conv, double max_time = 0.0)
+    {
+        if(min_conv < 0 || min_conv > nev)
+            throw std::invalid_argument("min_conv must satisfy 0 <= min_conv <= nev");
+        if(max_time < 0)
+            throw std::invalid_argument("max_time must be non-negative");
+
+        stop_minconv = min_conv;
+        stop_maxtime = max_time;
+    }
+
+    ///
+    /// Installing per-Ritz-position tolerances. Position `i` of the
+    /// sorted wanted values is tested against `tol_vals[i]` instead of
+    /// the uniform `tol` argument of compute(), so the leading values can
+    /// be required to a tight tolerance while the trailing ones are
+    /// accepted loosely.
+    ///
+    /// \param tol_vals Pointer to `nev` tolerances, copied internally.
+    ///                 Passing `NULL` removes previously installed
+    ///                 tolerances.
+    ///
+    void set_stop_tolerances(const Scalar *tol_vals)
+    {
+        if(tol_vals == NULL)
+        {
+            stop_tol.resize(0);
+            return;
+        }
+        stop_tol.resize(nev);
+        std::copy(tol_vals, tol_vals + nev, stop_tol.data());
+    }
+
+    ///
+    /// Installing a callback that is invoked once per restart iteration
+    /// of compute() with the current Ritz values and residual estimates,
+    /// so that the caller can observe convergence or abort the solve by
+    /// returning `false` from the callback.
+    ///
+    /// \param cb   The callback function, or `NULL` to remove it.
+    /// \param data Opaque pointer passed through to every invocation.
+    ///
+    void set_iteration_callback(IterationCallback cb, void *data = NULL)
+    {
+        stop_callback = cb;
+        stop_callback_data = data;
+        ws_resid.resize(nev);
+    }
+
+    ///
+    /// Enabling adaptive tuning of the subspace size (the `ncv` parameter)
+    /// across the restarts. The solver keeps the size it was constructed
+    /// with until the convergence history says otherwise: a window of
+    /// restarts without any new converged eigenvalue grows the subspace
+    /// geometrically toward `max_ncv`, and a window where every restart
+    /// converges a new one shrinks it toward `min_ncv`, cutting the
+    /// \f$O(n\cdot ncv)\f$ orthogonalization work and the \f$O(ncv^3)\f$
+    /// restart work per iteration. The optimal `ncv` varies widely between
+    /// matrix families, and this mode removes the need to provision for
+    /// the worst case.
+    ///
+    /// This function must be called before init(). When the basis lives
+    /// in a caller-supplied buffer, the buffer must hold at least
+    /// \f$n\times max\_ncv\f$ scalars, since the basis may grow into it.
+    ///
+    /// \param min_ncv Lower bound of the subspace size. This should satisfy
+    ///                \f$nev+2 \le min\_ncv \le max\_ncv\f$.
+    /// \param max_ncv Upper bound of the subspace size. This should satisfy
+    ///                \f$max\_ncv \le n\f$, where \f$n\f$ is the size of matrix.
+    /// \param window  Number of consecutive restarts observed before each
+    ///                adjustment.
+    ///
+    void set_ncv_bounds(int min_ncv, int max_ncv, int window = 5)
+    {
+        if(min_ncv < nev + 2 || min_ncv > max_ncv || max_ncv > dim_n)
+            throw std::invalid_argument("ncv bounds must satisfy nev + 2 <= min_ncv <= max_ncv <= n, n is the size of matrix");
+
+        if(window < 1)
+            throw std::invalid_argument("window must be at least one restart");
+
+        if(MaxNcv != Eigen::Dynamic && max_ncv > MaxNcv)
+            throw std::invalid_argument("max_ncv exceeds the MaxNcv template parameter");
+
+        ncv_min = min_ncv;
+        ncv_max = max_ncv;
+        adapt_window = window;
+        if(ncv < ncv_min)  ncv = ncv_min;
+        if(ncv > ncv_max)  ncv = ncv_max;
+        ncv_next = ncv;
+    }
+
+    ///
+    /// Returning the current size of the working subspace. This equals the
+    /// `ncv` parameter given to the constructor, unless adaptive tuning
+    /// has been enabled through set_ncv_bounds() and has moved it.
+    ///
+    int subspace_size() { return ncv; }
+
+    ///
+    /// Returning the basis product policy object of the solver. The
+    /// reference is mutable so that a policy carrying its own resources,
+    /// e.g. device buffers, can be configured before compute().
+    ///
+    GemvPolicy & basis_gemv() { return gemv_impl; }
+
     ///
     /// Returning the converged eigenvalues.
     ///
@@ -476,22 +1091,39 @@ public:
         int nconv = ritz_conv.cast<int>().sum();
         ComplexVector res(nconv);
 
-        if(!nconv)
-            return res;
+        if(nconv)
+            eigenvalues(res.data());
 
+        return res;
+    }
+
+    ///
+    /// Writing the converged eigenvalues directly into a caller-supplied
+    /// buffer, avoiding the allocation of the returned vector.
+    ///
+    /// \param dest Pointer to a buffer of at least num_converged_eigenvalues()
+    ///             complex scalars.
+    ///
+    void eigenvalues(Complex *dest)
+    {
         int j = 0;
         for(int i = 0; i < nev; i++)
         {
             if(ritz_conv[i])
             {
-                res[j] = ritz_val[i];
+                dest[j] = ritz_val[i];
                 j++;
             }
         }
-
-        return res;
     }
 
+    ///
+    /// Returning the number of converged eigenvalues, i.e. the number of
+    /// values written by eigenvalues(Complex *) and the maximum number of
+    /// columns written by eigenvectors(Complex *, int).
+    ///
+    int num_converged_eigenvalues() { return ritz_conv.cast<int>().sum(); }
+
     ///
     /// Returning the eigenvectors associated with the converged eigenvalues.
     ///
@@ -507,8 +1139,39 @@ public:
         nvec = std::min(nvec, nconv);
         ComplexMatrix res(dim_n, nvec);
 
+        if(nvec)
+            eigenvectors(res.data(), nvec);
+
+        return res;
+    }
+
+    ///
+    /// Returning all converged eigenvectors.
+    ///
+    ComplexMatrix eigenvectors()
+    {
+        return eigenvectors(nev);
+    }
+
+    ///
+    /// Writing the converged eigenvectors directly into a caller-supplied
+    /// buffer, so that no \f$n\times nvec\f$ matrix is allocated or copied.
+    /// The product of the basis and the Ritz coefficients is evaluated
+    /// straight into the destination; the only temporary is the small
+    /// \f$ncv\times nvec\f$ gather of the converged coefficient columns.
+    ///
+    /// \param dest Pointer to a buffer of at least \f$n\times nvec\f$
+    ///             complex scalars, which will be filled in column-major
+    ///             order.
+    /// \param nvec The number of eigenvectors to write. It is capped by the
+    ///             number of converged eigenvalues.
+    ///
+    void eigenvectors(Complex *dest, int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
         if(!nvec)
-            return res;
+            return;
 
         ComplexMatrix ritz_vec_conv(ncv, nvec);
         int j = 0;
@@ -521,17 +1184,31 @@ public:
             }
         }
 
+        Eigen::Map<ComplexMatrix> res(dest, dim_n, nvec);
         res.noalias() = fac_V * ritz_vec_conv;
+    }
 
-        return res;
+    ///
+    /// Returning a read-only view of the basis \f$V\f$ of the Arnoldi
+    /// factorization, without copying it. Together with ritz_vectors(),
+    /// consumers that only need a few eigenvector columns can form
+    /// `basis() * ritz_vectors().col(i)` lazily instead of materializing
+    /// all of them.
+    ///
+    Eigen::Map<const Matrix> basis()
+    {
+        return Eigen::Map<const Matrix>(fac_V.data(), dim_n, ncv);
     }
 
     ///
-    /// Returning all converged eigenvectors.
+    /// Returning a read-only view of the Ritz coefficient vectors, i.e. the
+    /// coordinates of the Ritz vectors in the basis \f$V\f$. Column \f$i\f$
+    /// corresponds to the \f$i\f$-th value of the sorted Ritz values, and
+    /// only converged columns represent eigenvectors.
     ///
-    ComplexMatrix eigenvectors()
+    Eigen::Map<const ComplexMatrix> ritz_vectors()
     {
-        return eigenvectors(nev);
+        return Eigen::Map<const ComplexMatrix>(ritz_vec.data(), ncv, nev);
     }
 };
 
@@ -560,8 +1237,11 @@ public:
 ///
 template <typename Scalar = double,
           int SelectionRule = LARGEST_MAGN,
-          typename OpType = DenseGenRealShiftSolve<double> >
-class GenEigsRealShiftSolver: public GenEigsSolver<Scalar, SelectionRule, OpType>
+          typename OpType = DenseGenRealShiftSolve<double>,
+          typename StatsPolicy = NullSolverStats<Scalar>,
+          typename GemvPolicy = HostBasisGemv<Scalar>,
+          int MaxNcv = Eigen::Dynamic >
+class GenEigsRealShiftSolver: public GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>
 {
 private:
     typedef std::complex<Scalar> Complex;
@@ -576,7 +1256,7 @@ private:
         // So the eigenvalues of the original problem is lambda = 1 / nu + sigma
         ComplexArray ritz_val_org = Scalar(1.0) / this->ritz_val.head(this->nev).array() + sigma;
         this->ritz_val.head(this->nev) = ritz_val_org;
-        GenEigsSolver<Scalar, SelectionRule, OpType>::sort_ritzpair();
+        GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>::sort_ritzpair();
     }
 public:
     ///
@@ -598,7 +1278,7 @@ public:
     /// \param sigma_ The real-valued shift.
     ///
     GenEigsRealShiftSolver(OpType *op_, int nev_, int ncv_, Scalar sigma_) :
-        GenEigsSolver<Scalar, SelectionRule, OpType>(op_, nev_, ncv_),
+        GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>(op_, nev_, ncv_),
         sigma(sigma_)
     {
         this->op->set_shift(sigma);
@@ -630,8 +1310,11 @@ public:
 ///
 template <typename Scalar = double,
           int SelectionRule = LARGEST_MAGN,
-          typename OpType = DenseGenComplexShiftSolve<double> >
-class GenEigsComplexShiftSolver: public GenEigsSolver<Scalar, SelectionRule, OpType>
+          typename OpType = DenseGenComplexShiftSolve<double>,
+          typename StatsPolicy = NullSolverStats<Scalar>,
+          typename GemvPolicy = HostBasisGemv<Scalar>,
+          int MaxNcv = Eigen::Dynamic >
+class GenEigsComplexShiftSolver: public GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>
 {
 private:
     typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
@@ -685,7 +1368,7 @@ private:
             }
         }
 
-        GenEigsSolver<Scalar, SelectionRule, OpType>::sort_ritzpair();
+        GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>::sort_ritzpair();
     }
 public:
     ///
@@ -708,7 +1391,7 @@ public:
     /// \param sigmai_ The imaginary part of the shift.
     ///
     GenEigsComplexShiftSolver(OpType *op_, int nev_, int ncv_, Scalar sigmar_, Scalar sigmai_) :
-        GenEigsSolver<Scalar, SelectionRule, OpType>(op_, nev_, ncv_),
+        GenEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, GemvPolicy, MaxNcv>(op_, nev_, ncv_),
         sigmar(sigmar_), sigmai(sigmai_)
     {
         this->op->set_shift(sigmar, sigmai);
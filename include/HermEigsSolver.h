@@ -0,0 +1,742 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HERM_EIGS_SOLVER_H
+#define HERM_EIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <vector>     // std::vector
+#include <cmath>      // std::abs, std::pow
+#include <algorithm>  // std::min, std::copy
+#include <complex>    // std::complex
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+
+#include "SelectionRule.h"
+#include "ReorthRule.h"
+#include "SolverStats.h"
+#include "UpperHessenbergQR.h"
+#include "TridiagEigen.h"
+#include "MatOp/DenseGenMatProd.h"
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements the eigen solver for complex Hermitian matrices.
+///
+/// A Hermitian matrix \f$A\f$ satisfies \f$A=A^H\f$, so its eigenvalues are
+/// real even though the matrix elements and the eigenvectors are complex.
+/// The Lanczos recurrence exploits this: with a complex basis \f$V\f$, the
+/// projection \f$V^H AV\f$ is a **real** tridiagonal matrix, since each
+/// diagonal element \f$v_i^H Av_i\f$ is real and each off-diagonal element
+/// is a residual norm. The solver therefore keeps the same real tridiagonal
+/// \f$H\f$ as SymEigsSolver, and reuses its TridiagEigen decomposition and
+/// TridiagQR restart sweeps unchanged; only the basis vectors and the
+/// matrix-vector products are complex.
+///
+/// Compared with solving the equivalent \f$2n\times 2n\f$ real symmetric
+/// embedding, this halves the number of matrix-vector products and the
+/// basis storage, and avoids the doubled (paired) eigenvalues that the
+/// embedding produces.
+///
+/// The matrix operation class works on `std::complex<Scalar>` vectors. For
+/// a matrix stored as an **Eigen** object, e.g. `Eigen::MatrixXcd`, the
+/// DenseGenMatProd wrapper instantiated with a complex element type can be
+/// used directly, and is the default template parameter.
+///
+/// \tparam Scalar        The **real** element type underlying the matrix,
+///                       i.e. the matrix elements have the type
+///                       `std::complex<Scalar>`. Currently supported types
+///                       are `float`, `double` and `long double`.
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the requested eigenvalues, for example `LARGEST_MAGN`
+///                       to retrieve eigenvalues with the largest magnitude.
+///                       The full list of enumeration values can be found in
+///                       SelectionRule.h .
+/// \tparam OpType        The name of the matrix operation class. Users could
+///                       either use the DenseGenMatProd wrapper class with a
+///                       complex element type, or define their own that
+///                       impelemnts all its public member functions with
+///                       `std::complex<Scalar>` arguments.
+/// \tparam StatsPolicy   The statistics policy class. The default NullSolverStats
+///                       compiles all instrumentation out; passing SolverStats
+///                       instead makes the solver record per-phase wall time and
+///                       event counts, accessible through the stats() member.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <HermEigsSolver.h>  // Also includes <MatOp/DenseGenMatProd.h>
+/// #include <iostream>
+///
+/// int main()
+/// {
+///     // We are going to calculate the eigenvalues of H
+///     Eigen::MatrixXcd A = Eigen::MatrixXcd::Random(10, 10);
+///     Eigen::MatrixXcd H = A + A.adjoint();
+///
+///     // Construct matrix operation object using the wrapper class
+///     DenseGenMatProd< std::complex<double> > op(H);
+///
+///     // Construct eigen solver object, requesting the largest three eigenvalues
+///     HermEigsSolver< double, LARGEST_ALGE,
+///                     DenseGenMatProd< std::complex<double> > > eigs(&op, 3, 6);
+///
+///     // Initialize and compute
+///     eigs.init();
+///     int nconv = eigs.compute();
+///
+///     // The eigenvalues of a Hermitian matrix are real
+///     Eigen::VectorXd evalues;
+///     if(nconv > 0)
+///         evalues = eigs.eigenvalues();
+///
+///     std::cout << "Eigenvalues found:\n" << evalues << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template < typename Scalar = double,
+           int SelectionRule = LARGEST_MAGN,
+           typename OpType = DenseGenMatProd< std::complex<double> >,
+           typename StatsPolicy = NullSolverStats<Scalar> >
+class HermEigsSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
+    typedef Eigen::Array<bool, Eigen::Dynamic, 1> BoolArray;
+
+    typedef std::complex<Scalar> Complex;
+    typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic> ComplexMatrix;
+    typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1> ComplexVector;
+    typedef Eigen::Map<ComplexMatrix> MapCMat;
+
+protected:
+    OpType *op;             // object to conduct matrix operation,
+                            // e.g. matrix-vector product
+    const int dim_n;        // dimension of matrix A
+    const int nev;          // number of eigenvalues requested
+
+private:
+    const int ncv;          // number of ritz values
+    int nmatop;             // number of matrix operations called
+    int niter;              // number of restarting iterations
+
+    ComplexMatrix fac_V;    // V matrix in the Lanczos factorization
+    Matrix fac_H;           // H matrix in the Lanczos factorization;
+                            // real tridiagonal, as in SymEigsSolver
+    ComplexVector fac_f;    // residual in the Lanczos factorization
+
+protected:
+    Vector ritz_val;        // ritz values; real for a Hermitian matrix
+
+private:
+    Matrix ritz_vec;        // ritz vectors, as real coordinates in the
+                            // complex basis V
+    Vector ritz_est;        // last row of the eigenvector matrix of fac_H,
+                            // used to estimate residuals during the restart
+                            // iterations without computing full Ritz vectors
+    BoolArray ritz_conv;    // indicator of the convergence of ritz values
+
+    const Scalar prec;      // precision parameter used to test convergence
+                            // prec = epsilon^(2/3)
+                            // epsilon is the machine precision,
+                            // e.g. ~= 1e-16 for the "double" type
+
+    int reorth_rule;        // reorthogonalization strategy, one of the
+                            // REORTH_* enumeration values
+
+    // Preallocated workspace, sized once in init(), so that the hot-path
+    // routines below do not touch the heap during the iterations
+    ComplexVector ws_w;        // length-n scratch to receive perform_op() results
+    ComplexVector ws_Vf;       // coefficients in the reorthogonalization step
+    ComplexVector ws_fk;       // new residual vector computed in restart()
+    Matrix ws_Q;               // accumulated rotation matrix in restart()
+    ComplexMatrix ws_Qc;       // complex copy of the ws_Q columns applied to
+                               // the basis, so that the update is a single
+                               // complex level-3 product
+    ComplexMatrix ws_Vs;       // new basis columns computed in restart()
+    Vector ws_col;             // real scratch column used in sort_ritzpair()
+    TridiagQR<Scalar> ws_decomp;  // QR decomposition reused for all shifts
+    TridiagEigen<Scalar> ws_eig;  // eigen decomposition of fac_H, reused
+                                  // across the restarts
+    SortEigenvalue<Scalar, SelectionRule> ws_sort;  // sorting machinery,
+                                                    // reused across the restarts
+    std::vector<int> ws_ind;      // order index of the Ritz values
+    std::vector<int> ws_ind2;     // scratch for the BOTH_ENDS reordering
+
+    StatsPolicy stats_rec;     // per-phase statistics, a no-op recorder
+                               // by default
+
+    // Lanczos factorization starting from step-k
+    void factorize_from(int from_k, int to_m, const ComplexVector &fk)
+    {
+        if(to_m <= from_k) return;
+
+        fac_f = fk;
+
+        Scalar beta = 0.0, Hii = 0.0;
+        // Keep the upperleft k x k submatrix of H and set other elements to 0
+        fac_H.rightCols(ncv - from_k).setZero();
+        fac_H.block(from_k, 0, ncv - from_k, from_k).setZero();
+        for(int i = from_k; i <= to_m - 1; i++)
+        {
+            beta = fac_f.norm();
+            fac_V.col(i).noalias() = fac_f / beta; // The (i+1)-th column
+            fac_H(i, i - 1) = beta;
+
+            // For the default NullSolverStats policy, wall_time() is an
+            // inline constant and the add_*() calls are empty, so the
+            // timing code below disappears at compile time
+            double t_op = StatsPolicy::wall_time();
+            op->perform_op(&fac_V(0, i), ws_w.data());
+            nmatop++;
+            stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
+
+            // v' * A * v is real for a Hermitian A; the imaginary part is
+            // rounding noise and is dropped
+            Hii = fac_V.col(i).dot(ws_w).real();
+            fac_H(i - 1, i) = beta;
+            fac_H(i, i) = Hii;
+
+            fac_f.noalias() = ws_w - beta * fac_V.col(i - 1) - Hii * fac_V.col(i);
+            reorthogonalize(i + 1);
+        }
+    }
+
+    // One classical Gram-Schmidt correction pass of fac_f against the
+    // first ncols basis columns. Both the projection and the update are
+    // GEMV passes over a contiguous column panel of fac_V, which go
+    // through the blocked level-2 kernels
+    void reorth_pass(int ncols)
+    {
+        ws_Vf.head(ncols).noalias() = fac_V.leftCols(ncols).adjoint() * fac_f;
+        fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+    }
+
+    // Orthogonality maintenance of fac_f against the first ncols basis
+    // columns, following the strategy selected by reorth_rule
+    void reorthogonalize(int ncols)
+    {
+        if(reorth_rule == REORTH_NONE)
+            return;
+
+        double t_re = StatsPolicy::wall_time();
+        if(reorth_rule == REORTH_FULL)
+        {
+            stats_rec.reorth_hit();
+            reorth_pass(ncols);
+        }
+        else if(reorth_rule == REORTH_DGKS)
+        {
+            // Iterated CGS with the eta test of Daniel, Gragg, Kaufman
+            // and Stewart: a correction pass is needed whenever the new
+            // residual is much shorter than the vector it was computed
+            // from, and is repeated while that keeps being the case
+            const Scalar eta = Scalar(1) / std::sqrt(Scalar(2));
+            Scalar last = ws_w.norm();
+            Scalar fnorm = fac_f.norm();
+            for(int pass = 0; pass < 3 && fnorm < eta * last; pass++)
+            {
+                stats_rec.reorth_hit();
+                reorth_pass(ncols);
+                last = fnorm;
+                fnorm = fac_f.norm();
+            }
+        }
+        else  // REORTH_STANDARD
+        {
+            // Correct f if it is not orthogonal to V
+            // Typically the largest absolute value occurs in
+            // the first element, i.e., <v1, f>, so we use this
+            // to test the orthogonality
+            Complex v1f = fac_V.col(0).dot(fac_f);
+            if(std::abs(v1f) > prec)
+            {
+                ws_Vf.segment(1, ncols - 1).noalias() = fac_V.block(0, 1, dim_n, ncols - 1).adjoint() * fac_f;
+                ws_Vf[0] = v1f;
+                fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+                stats_rec.reorth_hit();
+            }
+        }
+        stats_rec.add_reorth_time(StatsPolicy::wall_time() - t_re);
+    }
+
+    // Implicitly restarted Lanczos factorization
+    void restart(int k)
+    {
+        if(k >= ncv)
+            return;
+
+        ws_Q.setIdentity();
+
+        double t_rs = StatsPolicy::wall_time();
+
+        // The shifts and the QR sweeps are entirely real: they act on the
+        // real tridiagonal H, exactly as in SymEigsSolver, with all the
+        // shifts of the sweep fused into one pass over the accumulator
+        ws_decomp.sweep_shifts(fac_H, ritz_val.segment(k, ncv - k), ws_Q);
+        // V -> VQ, only need to update the first k+1 columns. The real
+        // rotation columns are widened once, so that the basis update is
+        // a single complex matrix-matrix product through the blocked
+        // level-3 kernels
+        ws_Qc.leftCols(k + 1) = ws_Q.leftCols(k + 1).template cast<Complex>();
+        ws_Vs.leftCols(k + 1).noalias() = fac_V * ws_Qc.leftCols(k + 1);
+        fac_V.leftCols(k + 1).noalias() = ws_Vs.leftCols(k + 1);
+
+        stats_rec.restart_hit();
+        stats_rec.add_restart_time(StatsPolicy::wall_time() - t_rs);
+
+        ws_fk.noalias() = fac_f * ws_Q(ncv - 1, k - 1) + fac_V.col(k) * fac_H(k, k - 1);
+        factorize_from(k, ncv, ws_fk);
+        // Full Ritz vectors are not needed inside the iterations
+        retrieve_ritzpair(false);
+    }
+
+    // Calculate the number of converged Ritz values
+    int num_converged(Scalar tol)
+    {
+        // thresh = tol * max(prec, abs(theta)), theta for ritz value
+        Array thresh = tol * ritz_val.head(nev).array().abs().max(prec);
+        Array resid = ritz_est.head(nev).array().abs() * fac_f.norm();
+        // Converged "wanted" ritz values
+        ritz_conv = (resid < thresh);
+
+        return ritz_conv.cast<int>().sum();
+    }
+
+    // Return the adjusted nev for restarting
+    int nev_adjusted(int nconv)
+    {
+        int nev_new = nev;
+
+        // Adjust nev_new, according to dsaup2.f line 677~684 in ARPACK
+        nev_new = nev + std::min(nconv, (ncv - nev) / 2);
+        if(nev == 1 && ncv >= 6)
+            nev_new = ncv / 2;
+        else if(nev == 1 && ncv > 2)
+            nev_new = 2;
+
+        return nev_new;
+    }
+
+    // Retrieve and sort ritz values and ritz vectors
+    // When compute_vecs is false, only the Ritz values and the residual
+    // estimates in ritz_est are updated, which avoids the O(ncv^3)
+    // eigenvector accumulation on every restart
+    void retrieve_ritzpair(bool compute_vecs = true)
+    {
+        double t_rz = StatsPolicy::wall_time();
+        // The decomposition object, the sorting machinery and the index
+        // vectors are all preallocated members, so this routine performs
+        // no memory allocation during the restart iterations
+        ws_eig.compute(fac_H, compute_vecs);
+        const Vector &evals = ws_eig.eigenvalues();
+        const Vector &brow = ws_eig.eigenvectors_bottom_row();
+
+        ws_sort.compute(evals.data(), ncv);
+        int *ind = &ws_ind[0];
+
+        // For BOTH_ENDS, the eigenvalues are sorted according
+        // to the LARGEST_ALGE rule, so we need to move those smallest
+        // values to the left
+        // The order would be
+        // Largest => Smallest => 2nd largest => 2nd smallest => ...
+        // We keep this order since the first k values will always be
+        // the wanted collection, no matter k is nev_updated (used in restart())
+        // or is nev (used in sort_ritzpair())
+        if(SelectionRule == BOTH_ENDS)
+        {
+            ws_sort.index(&ws_ind2[0]);
+            for(int i = 0; i < ncv; i++)
+            {
+                // If i is even, pick values from the left (large values)
+                // If i is odd, pick values from the right (small values)
+                if(i % 2 == 0)
+                    ind[i] = ws_ind2[i / 2];
+                else
+                    ind[i] = ws_ind2[ncv - 1 - i / 2];
+            }
+        } else {
+            ws_sort.index(ind);
+        }
+
+        // Copy the ritz values and vectors to ritz_val and ritz_vec, respectively
+        for(int i = 0; i < ncv; i++)
+        {
+            ritz_val[i] = evals[ind[i]];
+            ritz_est[i] = brow[ind[i]];
+        }
+        if(compute_vecs)
+        {
+            const Matrix &evecs = ws_eig.eigenvectors();
+            for(int i = 0; i < nev; i++)
+            {
+                ritz_vec.col(i) = evecs.col(ind[i]);
+            }
+        }
+
+        stats_rec.add_ritz_time(StatsPolicy::wall_time() - t_rz);
+    }
+
+protected:
+    // Sort the first nev Ritz pairs in decreasing magnitude order
+    // This is used to return the final results
+    virtual void sort_ritzpair()
+    {
+        SortEigenvalue<Scalar, LARGEST_ALGE> sorting(ritz_val.data(), nev);
+        sorting.index(&ws_ind[0]);
+
+        // Apply the permutation in place by following its cycles, so that
+        // no new containers need to be allocated. ws_col serves as the
+        // temporary for the coefficient column being moved.
+        for(int i = 0; i < nev; i++)
+        {
+            if(ws_ind[i] == i)
+                continue;
+
+            Scalar val = ritz_val[i];
+            bool conv = ritz_conv[i];
+            ws_col.noalias() = ritz_vec.col(i);
+            int j = i;
+            for(;;)
+            {
+                const int k = ws_ind[j];
+                ws_ind[j] = j;
+                if(k == i)
+                    break;
+                ritz_val[j] = ritz_val[k];
+                ritz_conv[j] = ritz_conv[k];
+                ritz_vec.col(j) = ritz_vec.col(k);
+                j = k;
+            }
+            ritz_val[j] = val;
+            ritz_conv[j] = conv;
+            ritz_vec.col(j) = ws_col;
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op_  Pointer to the matrix operation object, which should implement
+    ///             the matrix-vector multiplication operation of \f$A\f$:
+    ///             calculating \f$Ay\f$ for any complex vector \f$y\f$. Users
+    ///             could either create the object from the DenseGenMatProd
+    ///             wrapper class with a complex element type, or define their
+    ///             own that impelemnts all its public member functions.
+    /// \param nev_ Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-1\f$,
+    ///             where \f$n\f$ is the size of matrix.
+    /// \param ncv_ Parameter that controls the convergence speed of the algorithm.
+    ///             Typically a larger `ncv_` means faster convergence, but it may
+    ///             also result in greater memory use and more matrix operations
+    ///             in each iteration. This parameter must satisfy \f$nev < ncv \le n\f$,
+    ///             and is advised to take \f$ncv \ge 2\cdot nev\f$.
+    ///
+    HermEigsSolver(OpType *op_, int nev_, int ncv_) :
+        op(op_),
+        dim_n(op->rows()),
+        nev(nev_),
+        ncv(ncv_ > dim_n ? dim_n : ncv_),
+        nmatop(0),
+        niter(0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD)
+    {
+        if(nev_ < 1 || nev_ > dim_n - 1)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
+
+        if(ncv_ <= nev_ || ncv_ > dim_n)
+            throw std::invalid_argument("ncv must satisfy nev < ncv <= n, n is the size of matrix");
+    }
+
+    ///
+    /// Providing the initial residual vector for the algorithm.
+    ///
+    /// \param init_resid Pointer to the initial residual vector.
+    ///
+    /// **ARPACK-Eigen** (and also **ARPACK**) uses an iterative algorithm
+    /// to find eigenvalues. This function allows the user to provide the initial
+    /// residual vector.
+    ///
+    void init(const Complex *init_resid)
+    {
+        // Reset all matrices/vectors to zero
+        fac_V.resize(dim_n, ncv);
+        fac_H.resize(ncv, ncv);
+        fac_f.resize(dim_n);
+        ritz_val.resize(ncv);
+        ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
+        ritz_conv.resize(nev);
+
+        // Allocate the workspace here, so that the iterations
+        // can run without any memory allocation
+        ws_w.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Qc.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_col.resize(ncv);
+        ws_ind.resize(ncv);
+        ws_ind2.resize(ncv);
+
+        fac_V.setZero();
+        fac_H.setZero();
+        fac_f.setZero();
+        ritz_val.setZero();
+        ritz_vec.setZero();
+        ritz_est.setZero();
+        ritz_conv.setZero();
+
+        nmatop = 0;
+        niter = 0;
+        stats_rec.reset();
+
+        ComplexVector v(dim_n);
+        std::copy(init_resid, init_resid + dim_n, v.data());
+        Scalar vnorm = v.norm();
+        if(vnorm < prec)
+            throw std::invalid_argument("initial residual vector cannot be zero");
+        v /= vnorm;
+
+        double t_op = StatsPolicy::wall_time();
+        op->perform_op(v.data(), ws_w.data());
+        nmatop++;
+        stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
+
+        fac_H(0, 0) = v.dot(ws_w).real();
+        fac_f = ws_w - v * fac_H(0, 0);
+        fac_V.col(0) = v;
+    }
+
+    ///
+    /// Providing a random initial residual vector.
+    ///
+    /// This overloaded function generates a random initial residual vector
+    /// for the algorithm. Both the real and the imaginary parts of the
+    /// elements follow independent uniform distributions.
+    ///
+    void init()
+    {
+        ComplexVector init_resid = ComplexVector::Random(dim_n);
+        init(init_resid.data());
+    }
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        // The m-step Lanczos factorization
+        // ws_fk is used here since factorize_from() overwrites fac_f
+        ws_fk = fac_f;
+        factorize_from(1, ncv, ws_fk);
+        niter++;
+
+        return compute_continue(maxit, tol);
+    }
+
+    ///
+    /// Resuming the computation from the current Lanczos factorization,
+    /// without rebuilding it from the initial residual vector. It can be
+    /// called after compute() has exhausted its iteration allowance, and
+    /// all the progress made before is kept.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute_continue(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        retrieve_ritzpair(false);
+        // Restarting
+        int i, nconv = 0, nev_adj;
+        for(i = 0; i < maxit; i++)
+        {
+            nconv = num_converged(tol);
+            // The residual norms below are only computed when a recording
+            // statistics policy is in use
+            if(StatsPolicy::enabled)
+                stats_rec.iteration(niter + i, nconv,
+                    (ritz_est.head(nev).array().abs() * fac_f.norm()).maxCoeff());
+            if(nconv >= nev)
+                break;
+
+            nev_adj = nev_adjusted(nconv);
+            restart(nev_adj);
+        }
+        // The iterations above only work with Ritz values and residual
+        // estimates; compute the full Ritz vectors once at the end
+        retrieve_ritzpair(true);
+        nconv = num_converged(tol);
+        // Sorting results
+        sort_ritzpair();
+
+        niter += i;
+
+        return std::min(nev, nconv);
+    }
+
+    ///
+    /// Returning the number of iterations used in the computation.
+    ///
+    int num_iterations() { return niter; }
+
+    ///
+    /// Returning the number of matrix operations used in the computation.
+    ///
+    int num_operations() { return nmatop; }
+
+    ///
+    /// Returning the statistics object of the solver. For the default
+    /// NullSolverStats policy this object records nothing; instantiate the
+    /// solver with SolverStats as the `StatsPolicy` template parameter to
+    /// obtain per-phase wall times, reorthogonalization and restart counts,
+    /// and the per-iteration residual norms. The reference is mutable so
+    /// that a per-iteration callback can be installed before compute().
+    ///
+    StatsPolicy & stats() { return stats_rec; }
+
+    ///
+    /// Selecting the reorthogonalization strategy used in the Lanczos
+    /// factorization. The full list of enumeration values can be found in
+    /// ReorthRule.h . The default REORTH_STANDARD keeps the behavior of
+    /// the other solvers; REORTH_DGKS is recommended for ill-conditioned
+    /// operators.
+    ///
+    /// \param rule One of the `REORTH_*` enumeration values.
+    ///
+    void set_reorth_rule(int rule) { reorth_rule = rule; }
+
+    ///
+    /// Returning the converged eigenvalues. The eigenvalues of a Hermitian
+    /// matrix are real, so the result is a real vector.
+    ///
+    /// \return A vector containing the eigenvalues.
+    /// Returned vector type will be `Eigen::Vector<Scalar, ...>`, depending on
+    /// the template parameter `Scalar` defined.
+    ///
+    Vector eigenvalues()
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        Vector res(nconv);
+
+        if(nconv)
+            eigenvalues(res.data());
+
+        return res;
+    }
+
+    ///
+    /// Writing the converged eigenvalues directly into a caller-supplied
+    /// buffer, avoiding the allocation of the returned vector.
+    ///
+    /// \param dest Pointer to a buffer of at least num_converged_eigenvalues()
+    ///             scalars.
+    ///
+    void eigenvalues(Scalar *dest)
+    {
+        int j = 0;
+        for(int i = 0; i < nev; i++)
+        {
+            if(ritz_conv[i])
+            {
+                dest[j] = ritz_val[i];
+                j++;
+            }
+        }
+    }
+
+    ///
+    /// Returning the number of converged eigenvalues, i.e. the number of
+    /// values written by eigenvalues(Scalar *) and the maximum number of
+    /// columns written by eigenvectors(Complex *, int).
+    ///
+    int num_converged_eigenvalues() { return ritz_conv.cast<int>().sum(); }
+
+    ///
+    /// Returning the eigenvectors associated with the converged eigenvalues.
+    ///
+    /// \param nvec The number of eigenvectors to return.
+    ///
+    /// \return A complex-valued matrix containing the eigenvectors.
+    /// Returned matrix type will be `Eigen::Matrix<std::complex<Scalar>, ...>`,
+    /// depending on the template parameter `Scalar` defined.
+    ///
+    ComplexMatrix eigenvectors(int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
+        ComplexMatrix res(dim_n, nvec);
+
+        if(nvec)
+            eigenvectors(res.data(), nvec);
+
+        return res;
+    }
+
+    ///
+    /// Returning all converged eigenvectors.
+    ///
+    ComplexMatrix eigenvectors()
+    {
+        return eigenvectors(nev);
+    }
+
+    ///
+    /// Writing the converged eigenvectors directly into a caller-supplied
+    /// buffer, so that no \f$n\times nvec\f$ matrix is allocated or copied.
+    /// The product of the basis and the Ritz coefficients is evaluated
+    /// straight into the destination; the only temporary is the small
+    /// \f$ncv\times nvec\f$ gather of the converged coefficient columns.
+    ///
+    /// \param dest Pointer to a buffer of at least \f$n\times nvec\f$
+    ///             complex scalars, which will be filled in column-major
+    ///             order.
+    /// \param nvec The number of eigenvectors to write. It is capped by the
+    ///             number of converged eigenvalues.
+    ///
+    void eigenvectors(Complex *dest, int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
+        if(!nvec)
+            return;
+
+        // The Ritz coordinates are real; widen the converged columns once
+        // so that the basis product is a single complex level-3 product
+        ComplexMatrix ritz_vec_conv(ncv, nvec);
+        int j = 0;
+        for(int i = 0; i < nev && j < nvec; i++)
+        {
+            if(ritz_conv[i])
+            {
+                ritz_vec_conv.col(j) = ritz_vec.col(i).template cast<Complex>();
+                j++;
+            }
+        }
+
+        MapCMat res(dest, dim_n, nvec);
+        res.noalias() = fac_V * ritz_vec_conv;
+    }
+};
+
+
+#endif // HERM_EIGS_SOLVER_H
@@ -0,0 +1,97 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MMAP_BASIS_STORAGE_H
+#define MMAP_BASIS_STORAGE_H
+
+#include <string>
+#include <stdexcept>
+
+#include <fcntl.h>     // open
+#include <unistd.h>    // close, ftruncate
+#include <sys/mman.h>  // mmap, munmap
+
+///
+/// \ingroup EigenSolver
+///
+/// This class provides a memory-mapped file backing for the Arnoldi basis,
+/// so that problems whose \f$n\times ncv\f$ basis does not fit in RAM can
+/// still be solved. The mapped buffer is handed to the solver through the
+/// external-basis constructor:
+///
+/// \code{.cpp}
+/// MMapBasisStorage<double> storage("/scratch/basis.bin", n, ncv);
+/// SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>>
+///     eigs(&op, nev, ncv, storage.data());
+/// \endcode
+///
+/// The solver touches the basis almost exclusively through sequential
+/// column sweeps -- the reorthogonalization in the factorization reads the
+/// leading columns front to back, and the restart compression is a single
+/// matrix product over column panels -- so the access pattern pages well
+/// from fast local storage. The backing file is kept on destruction, which
+/// also makes it a natural companion of save_state()/load_state().
+///
+template <typename Scalar>
+class MMapBasisStorage
+{
+private:
+    const std::string filename;
+    Scalar *ptr;
+    size_t bytes;
+
+    // Not copyable: the class owns the mapping
+    MMapBasisStorage(const MMapBasisStorage &);
+    MMapBasisStorage & operator=(const MMapBasisStorage &);
+
+public:
+    ///
+    /// Constructor to create (or reuse) the backing file and map it.
+    ///
+    /// \param filename_ Path of the backing file. It is created if it does
+    ///                  not exist, and grown to the required size.
+    /// \param rows      Number of rows of the stored basis.
+    /// \param cols      Number of columns of the stored basis.
+    ///
+    MMapBasisStorage(const std::string &filename_, int rows, int cols) :
+        filename(filename_),
+        ptr(NULL),
+        bytes(size_t(rows) * cols * sizeof(Scalar))
+    {
+        int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0600);
+        if(fd < 0)
+            throw std::runtime_error("MMapBasisStorage: cannot open backing file");
+        if(::ftruncate(fd, bytes) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MMapBasisStorage: cannot grow backing file");
+        }
+        void *p = ::mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED)
+            throw std::runtime_error("MMapBasisStorage: mmap failed");
+        ptr = static_cast<Scalar *>(p);
+    }
+
+    ~MMapBasisStorage()
+    {
+        if(ptr)
+            ::munmap(ptr, bytes);
+    }
+
+    ///
+    /// Return the mapped buffer, to be passed to the solver constructor.
+    ///
+    Scalar *data() { return ptr; }
+
+    ///
+    /// Return the size of the mapped buffer, in number of scalars.
+    ///
+    size_t size() const { return bytes / sizeof(Scalar); }
+};
+
+
+#endif // MMAP_BASIS_STORAGE_H
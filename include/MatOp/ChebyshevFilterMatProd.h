@@ -0,0 +1,287 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CHEBYSHEV_FILTER_MAT_PROD_H
+#define CHEBYSHEV_FILTER_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>  // Eigen::SelfAdjointEigenSolver
+#include <cmath>      // std::acos, std::sin, std::cos, std::sqrt, std::abs
+#include <algorithm>  // std::min, std::max
+#include <stdexcept>  // std::invalid_argument, std::logic_error
+
+#include "SparseGenMatProd.h"
+
+///
+/// \ingroup MatOp
+///
+/// This class defines a Chebyshev polynomial filter over any existing
+/// matrix operation object: calculating \f$y=p(A)x\f$, where \f$p\f$ is a
+/// degree-\f$m\f$ Chebyshev expansion of the indicator function of a
+/// target interval \f$[lo, hi]\f$ inside the spectrum of the symmetric
+/// operator \f$A\f$. Eigenvalues inside the interval are mapped close to
+/// one and all others close to zero, so running SymEigsSolver with the
+/// `LARGEST_ALGE` rule on the filtered operator converges to the interior
+/// eigenvectors of \f$A\f$ at the cost of \f$m\f$ products with \f$A\f$
+/// per iteration — no factorization of any kind is needed, which makes
+/// interior problems bandwidth-bound instead of factorization-bound.
+///
+/// The expansion is evaluated with the three-term Chebyshev recurrence
+/// out of repeated perform_op() calls on the wrapped operator, and the
+/// coefficients carry Jackson damping to suppress the Gibbs oscillation
+/// of the truncated step function. The spectral bounds of \f$A\f$ that
+/// define the underlying \f$[-1,1]\f$ mapping can either be supplied
+/// directly or estimated with a short Lanczos run. It is mainly used in
+/// the SymEigsFilterSolver eigen solver.
+///
+template <typename Scalar = double, typename OpType = SparseGenMatProd<double> >
+class ChebyshevFilterMatProd
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::Map<const Vector> MapConstVec;
+
+    OpType *op;          // the wrapped matrix operation object
+    const int dim_n;     // dimension of the operator
+    const int degree;    // degree of the Chebyshev expansion
+
+    Scalar bound_lo;     // estimated or supplied lower bound of the spectrum
+    Scalar bound_hi;     // upper bound of the spectrum
+    bool bounds_set;
+
+    Scalar filter_lo;    // target interval
+    Scalar filter_hi;
+    Vector coef;         // damped expansion coefficients, degree + 1 of them
+    bool interval_set;
+
+    // Workspace of the three-term recurrence, sized once
+    Vector ws_t0;
+    Vector ws_t1;
+    Vector ws_t2;
+
+    // y = ((2 * A - (bhi + blo) * I) / (bhi - blo)) * x, the affine map
+    // of the operator onto [-1, 1]
+    void scaled_op(const Scalar *x_in, Vector &y)
+    {
+        const Scalar scale = Scalar(2) / (bound_hi - bound_lo);
+        const Scalar shift = (bound_hi + bound_lo) / (bound_hi - bound_lo);
+        op->perform_op(const_cast<Scalar *>(x_in), y.data());
+        MapConstVec x(x_in, dim_n);
+        y = scale * y - shift * x;
+    }
+
+public:
+    ///
+    /// Constructor to create the filtered matrix operation object.
+    ///
+    /// \param op_     Pointer to the matrix operation object of the symmetric
+    ///                operator \f$A\f$, e.g. a SparseGenMatProd object. It is
+    ///                applied `degree_` times by each perform_op() call.
+    /// \param degree_ Degree of the Chebyshev expansion. Higher degrees give
+    ///                a sharper filter and fewer solver iterations, at the
+    ///                price of more products with \f$A\f$ per iteration.
+    ///                Degrees in the range 40~100 are typical for narrow
+    ///                interior intervals.
+    ///
+    ChebyshevFilterMatProd(OpType *op_, int degree_ = 40) :
+        op(op_),
+        dim_n(op->rows()),
+        degree(degree_),
+        bound_lo(0), bound_hi(0), bounds_set(false),
+        filter_lo(0), filter_hi(0), interval_set(false),
+        ws_t0(dim_n), ws_t1(dim_n), ws_t2(dim_n)
+    {
+        if(degree_ < 2)
+            throw std::invalid_argument("ChebyshevFilterMatProd: degree must be at least 2");
+    }
+
+    ///
+    /// Return the number of rows of the underlying operator.
+    ///
+    int rows() { return dim_n; }
+    ///
+    /// Return the number of columns of the underlying operator.
+    ///
+    int cols() { return dim_n; }
+    ///
+    /// Return the lower spectral bound in use.
+    ///
+    Scalar spectral_lower() { return bound_lo; }
+    ///
+    /// Return the upper spectral bound in use.
+    ///
+    Scalar spectral_upper() { return bound_hi; }
+
+    ///
+    /// Supplying the bounds of the spectrum of \f$A\f$ directly, e.g. from
+    /// Gershgorin disks or from a previous run. The bounds do not need to
+    /// be tight, but all eigenvalues must lie inside \f$[blo, bhi]\f$,
+    /// since the polynomial grows exponentially outside the mapped
+    /// \f$[-1,1]\f$ interval.
+    ///
+    void set_spectral_bounds(Scalar blo, Scalar bhi)
+    {
+        if(blo >= bhi)
+            throw std::invalid_argument("ChebyshevFilterMatProd: spectral bounds must satisfy blo < bhi");
+
+        bound_lo = blo;
+        bound_hi = bhi;
+        bounds_set = true;
+    }
+
+    ///
+    /// Estimating the bounds of the spectrum of \f$A\f$ with a short
+    /// Lanczos run on the wrapped operator, expanded by the residual norm
+    /// as a safety margin.
+    ///
+    /// \param steps Number of Lanczos steps, typically 10~30.
+    ///
+    void estimate_spectral_bounds(int steps = 20)
+    {
+        steps = std::min(steps, dim_n);
+
+        // Plain Lanczos with full reorthogonalization on a small basis;
+        // the extreme Ritz values of the tridiagonal matrix estimate the
+        // extreme eigenvalues of A
+        Matrix V(dim_n, steps);
+        Vector alpha(steps), beta(steps);
+        Vector f(dim_n), w(dim_n);
+
+        f.setOnes();
+        f += Vector::LinSpaced(dim_n, Scalar(0), Scalar(1));  // break symmetry
+        f /= f.norm();
+        V.col(0) = f;
+        for(int i = 0; i < steps; i++)
+        {
+            op->perform_op(&V(0, i), w.data());
+            alpha[i] = V.col(i).dot(w);
+            f = w - alpha[i] * V.col(i);
+            if(i > 0)
+                f -= beta[i - 1] * V.col(i - 1);
+            // Full reorthogonalization, cheap at this basis size
+            f -= V.leftCols(i + 1) * (V.leftCols(i + 1).transpose() * f);
+            beta[i] = f.norm();
+            if(i + 1 < steps)
+            {
+                if(beta[i] <= Eigen::NumTraits<Scalar>::epsilon() * std::abs(alpha[i]))
+                {
+                    // Invariant subspace found, bounds are exact
+                    steps = i + 1;
+                    break;
+                }
+                V.col(i + 1) = f / beta[i];
+            }
+        }
+
+        Matrix T = Matrix::Zero(steps, steps);
+        T.diagonal() = alpha.head(steps);
+        T.diagonal(1) = beta.head(steps - 1);
+        T.diagonal(-1) = beta.head(steps - 1);
+        Eigen::SelfAdjointEigenSolver<Matrix> decomp(T);
+
+        // Expand by the residual norm, so that the true extreme
+        // eigenvalues cannot fall outside the bounds
+        const Scalar margin = beta[steps - 1] + Scalar(0.01) * (decomp.eigenvalues()[steps - 1] - decomp.eigenvalues()[0]);
+        bound_lo = decomp.eigenvalues()[0] - margin;
+        bound_hi = decomp.eigenvalues()[steps - 1] + margin;
+        bounds_set = true;
+    }
+
+    ///
+    /// Setting the target interval of the filter and computing the damped
+    /// expansion coefficients of its indicator function. The spectral
+    /// bounds must have been set or estimated before.
+    ///
+    /// \param lo Lower end of the target interval.
+    /// \param hi Upper end of the target interval.
+    ///
+    void set_interval(Scalar lo, Scalar hi)
+    {
+        if(!bounds_set)
+            throw std::logic_error("ChebyshevFilterMatProd: spectral bounds must be set before the interval");
+        if(lo >= hi)
+            throw std::invalid_argument("ChebyshevFilterMatProd: interval must satisfy lo < hi");
+        if(lo < bound_lo || hi > bound_hi)
+            throw std::invalid_argument("ChebyshevFilterMatProd: interval must lie inside the spectral bounds");
+
+        filter_lo = lo;
+        filter_hi = hi;
+
+        // Ends of the interval after the affine map onto [-1, 1]
+        const Scalar la = (Scalar(2) * lo - (bound_hi + bound_lo)) / (bound_hi - bound_lo);
+        const Scalar lb = (Scalar(2) * hi - (bound_hi + bound_lo)) / (bound_hi - bound_lo);
+        const Scalar ta = std::acos(la);
+        const Scalar tb = std::acos(lb);
+        const Scalar pi = Scalar(3.141592653589793238462643383279503L);
+
+        // Chebyshev coefficients of the indicator of [la, lb], with
+        // Jackson damping against the Gibbs oscillation of the truncated
+        // step function
+        const int m = degree;
+        coef.resize(m + 1);
+        coef[0] = (ta - tb) / pi;
+        for(int j = 1; j <= m; j++)
+        {
+            const Scalar c = Scalar(2) / (j * pi) * (std::sin(j * ta) - std::sin(j * tb));
+            const Scalar g = ((m - j + Scalar(2)) * std::cos(j * pi / (m + 2))
+                              + std::sin(j * pi / (m + 2)) / std::tan(pi / (m + 2))) / (m + 2);
+            coef[j] = c * g;
+        }
+
+        interval_set = true;
+    }
+
+    ///
+    /// Perform the filtered matrix-vector multiplication operation
+    /// \f$y=p(A)x\f$, using `degree` products with \f$A\f$ through the
+    /// three-term Chebyshev recurrence.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        if(!interval_set)
+            throw std::logic_error("ChebyshevFilterMatProd: need to call set_interval() first");
+
+        MapConstVec x(x_in, dim_n);
+        MapVec y(y_out, dim_n);
+
+        // t0 = T_0(B) x = x, t1 = T_1(B) x = B x, with B the operator
+        // mapped onto [-1, 1]
+        ws_t0 = x;
+        scaled_op(x_in, ws_t1);
+        y = coef[0] * ws_t0 + coef[1] * ws_t1;
+        for(int j = 2; j <= degree; j++)
+        {
+            // t2 = 2 B t1 - t0
+            scaled_op(ws_t1.data(), ws_t2);
+            ws_t2 = Scalar(2) * ws_t2 - ws_t0;
+            y += coef[j] * ws_t2;
+            ws_t0.swap(ws_t1);
+            ws_t1.swap(ws_t2);
+        }
+    }
+
+    ///
+    /// Perform the unfiltered matrix-vector multiplication operation
+    /// \f$y=Ax\f$ on the wrapped operator. It is used by
+    /// SymEigsFilterSolver to recover the original eigenvalues of the
+    /// converged subspace through Rayleigh quotients.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    void perform_base_op(const Scalar *x_in, Scalar *y_out)
+    {
+        op->perform_op(const_cast<Scalar *>(x_in), y_out);
+    }
+};
+
+
+#endif // CHEBYSHEV_FILTER_MAT_PROD_H
@@ -23,31 +23,45 @@
 /// \f$x\f$. It is mainly used in the GenEigsSolver and
 /// SymEigsSolver eigen solvers.
 ///
-template <typename Scalar>
+/// \tparam Scalar The element type of the matrix.
+/// \tparam Flags  Either `Eigen::ColMajor` (default) or `Eigen::RowMajor`,
+///                indicating the storage layout of the underlying matrix.
+///                Data mapped from an external row-major buffer can be
+///                used directly by setting `Eigen::RowMajor` here; the
+///                products are then formed with the transposed kernels
+///                internally, so no layout conversion or copy takes place.
+///
+template <typename Scalar, int Flags = Eigen::ColMajor>
 class DenseGenMatProd
 {
 private:
-    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Flags> Matrix;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
-    typedef Eigen::Map<const Matrix> MapMat;
     typedef Eigen::Map< Eigen::Matrix<Scalar, Eigen::Dynamic, 1> > MapVec;
 
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
 
-    const MapMat mat;
+    ConstGenericMatrix mat;
 
 public:
     ///
     /// Constructor to create the matrix operation object.
     ///
-    /// \param mat_ An **Eigen** matrix object, whose type can be
-    /// `Eigen::Matrix<Scalar, ...>` (e.g. `Eigen::MatrixXd` and
-    /// `Eigen::MatrixXf`), or its mapped version
-    /// (e.g. `Eigen::Map<Eigen::MatrixXd>`).
+    /// \param mat_ An **Eigen** matrix or matrix expression, e.g.
+    /// `Eigen::MatrixXd`, a mapped version of it over an externally owned
+    /// buffer (e.g. `Eigen::Map<Eigen::MatrixXd>`, possibly with an outer
+    /// stride), or a block of either. Objects with direct storage access
+    /// and a layout matching `Flags` are referenced without copying; any
+    /// other expression is evaluated once into a buffer owned by this
+    /// object.
     ///
-    DenseGenMatProd(ConstGenericMatrix &mat_) :
-        mat(mat_.data(), mat_.rows(), mat_.cols())
-    {}
+    template <typename Derived>
+    DenseGenMatProd(const Eigen::MatrixBase<Derived> &mat_) :
+        mat(mat_)
+    {
+        static_assert(static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(Matrix::IsRowMajor),
+                      "DenseGenMatProd: storage layout of the matrix does not match the Flags template parameter");
+    }
 
     ///
     /// Return the number of rows of the underlying matrix.
@@ -71,6 +85,27 @@ public:
         MapVec y(y_out, mat.rows());
         y.noalias() = mat * x;
     }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$Y=AX\f$ on
+    /// `ncols` vectors at once, so that a single level-3 product is issued
+    /// instead of `ncols` separate matrix-vector products. It is used by
+    /// the block eigen solvers.
+    ///
+    /// \param x_in  Pointer to the \f$X\f$ matrix, stored in column-major order.
+    /// \param y_out Pointer to the \f$Y\f$ matrix, stored in column-major order.
+    /// \param ncols Number of columns of \f$X\f$ and \f$Y\f$.
+    ///
+    // Y_out = A * X_in
+    void perform_op(Scalar *x_in, Scalar *y_out, int ncols)
+    {
+        // The buffers are always column-major regardless of the layout
+        // of the matrix itself
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> ColMatrix;
+        Eigen::Map<ColMatrix> x(x_in, mat.cols(), ncols);
+        Eigen::Map<ColMatrix> y(y_out, mat.rows(), ncols);
+        y.noalias() = mat * x;
+    }
 };
 
 
@@ -18,18 +18,23 @@
 /// i.e., calculating \f$y=(A-\sigma I)^{-1}x\f$ for any real \f$\sigma\f$ and
 /// vector \f$x\f$. It is mainly used in the GenEigsRealShiftSolver eigen solver.
 ///
-template <typename Scalar>
+/// \tparam Scalar The element type of the matrix.
+/// \tparam Flags  Either `Eigen::ColMajor` (default) or `Eigen::RowMajor`,
+///                indicating the storage layout of the underlying matrix,
+///                so that data mapped from an external row-major buffer
+///                can be used directly without a layout conversion.
+///
+template <typename Scalar, int Flags = Eigen::ColMajor>
 class DenseGenRealShiftSolve
 {
 private:
-    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Flags> Matrix;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
-    typedef Eigen::Map<const Matrix> MapMat;
     typedef Eigen::Map< Eigen::Matrix<Scalar, Eigen::Dynamic, 1> > MapVec;
 
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
 
-    const MapMat mat;
+    ConstGenericMatrix mat;
     const int dim_n;
     Eigen::PartialPivLU<Matrix> solver;
 
@@ -37,15 +42,22 @@ public:
     ///
     /// Constructor to create the matrix operation object.
     ///
-    /// \param mat_ An **Eigen** matrix object, whose type can be
-    /// `Eigen::Matrix<Scalar, ...>` (e.g. `Eigen::MatrixXd` and
-    /// `Eigen::MatrixXf`), or its mapped version
-    /// (e.g. `Eigen::Map<Eigen::MatrixXd>`).
+    /// \param mat_ An **Eigen** matrix or matrix expression, e.g.
+    /// `Eigen::MatrixXd`, a mapped version of it over an externally owned
+    /// buffer (e.g. `Eigen::Map<Eigen::MatrixXd>`, possibly with an outer
+    /// stride), or a block of either. Objects with direct storage access
+    /// and a layout matching `Flags` are referenced without copying; any
+    /// other expression is evaluated once into a buffer owned by this
+    /// object.
     ///
-    DenseGenRealShiftSolve(ConstGenericMatrix &mat_) :
-        mat(mat_.data(), mat_.rows(), mat_.cols()),
+    template <typename Derived>
+    DenseGenRealShiftSolve(const Eigen::MatrixBase<Derived> &mat_) :
+        mat(mat_),
         dim_n(mat_.rows())
     {
+        static_assert(static_cast<int>(Derived::PlainObject::IsRowMajor) == static_cast<int>(Matrix::IsRowMajor),
+                      "DenseGenRealShiftSolve: storage layout of the matrix does not match the Flags template parameter");
+
         if(mat_.rows() != mat_.cols())
             throw std::invalid_argument("DenseGenRealShiftSolve: matrix must be square");
     }
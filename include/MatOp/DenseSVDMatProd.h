@@ -0,0 +1,115 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DENSE_SVD_MAT_PROD_H
+#define DENSE_SVD_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <algorithm>  // std::min, std::max
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the matrix operation used by PartialSVDSolver on a
+/// dense rectangular matrix \f$A\f$: calculating \f$y=A'Ax\f$ when \f$A\f$
+/// is tall, or \f$y=AA'x\f$ when \f$A\f$ is wide, by applying the two
+/// factors one after the other. The Gram matrix is therefore never formed,
+/// which avoids its \f$O(\min(m,n)^2)\f$ storage and its squared
+/// condition number in the intermediate products.
+///
+template <typename Scalar>
+class DenseSVDMatProd
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<const Matrix> MapMat;
+    typedef Eigen::Map<Vector> MapVec;
+
+    typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
+
+    const MapMat mat;
+    const int dim;       // min(m, n), the dimension of the Gram operator
+    Vector ws;           // length-max(m, n) scratch for the inner product
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat_ An **Eigen** matrix object, whose type can be
+    /// `Eigen::Matrix<Scalar, ...>` (e.g. `Eigen::MatrixXd` and
+    /// `Eigen::MatrixXf`), or its mapped version
+    /// (e.g. `Eigen::Map<Eigen::MatrixXd>`).
+    ///
+    DenseSVDMatProd(ConstGenericMatrix &mat_) :
+        mat(mat_.data(), mat_.rows(), mat_.cols()),
+        dim(std::min(mat_.rows(), mat_.cols())),
+        ws(std::max(mat_.rows(), mat_.cols()))
+    {}
+
+    ///
+    /// Return the number of rows of the Gram operator, i.e. \f$\min(m,n)\f$.
+    ///
+    int rows() { return dim; }
+    ///
+    /// Return the number of columns of the Gram operator, i.e. \f$\min(m,n)\f$.
+    ///
+    int cols() { return dim; }
+    ///
+    /// Return the size of the long side of \f$A\f$, i.e. \f$\max(m,n)\f$,
+    /// which is the length of the vectors produced by apply_long().
+    ///
+    int long_dim() { return std::max(mat.rows(), mat.cols()); }
+    ///
+    /// Return whether the underlying matrix is tall (\f$m\ge n\f$), i.e.
+    /// whether the Gram operator represents \f$A'A\f$ rather than \f$AA'\f$.
+    ///
+    bool tall() { return mat.rows() >= mat.cols(); }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=A'Ax\f$
+    /// (\f$m\ge n\f$) or \f$y=AA'x\f$ (\f$m<n\f$).
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in, dim);
+        MapVec y(y_out, dim);
+        MapVec w(ws.data(), long_dim());
+        if(mat.rows() >= mat.cols())
+        {
+            w.noalias() = mat * x;
+            y.noalias() = mat.transpose() * w;
+        } else {
+            w.noalias() = mat.transpose() * x;
+            y.noalias() = mat * w;
+        }
+    }
+
+    ///
+    /// Apply the long-side factor to a short-side singular vector:
+    /// \f$y=Ax\f$ when \f$A\f$ is tall, or \f$y=A'x\f$ when \f$A\f$ is
+    /// wide. It is used by PartialSVDSolver to recover the singular
+    /// vectors on the long side of \f$A\f$.
+    ///
+    /// \param x_in  Pointer to a vector of length \f$\min(m,n)\f$.
+    /// \param y_out Pointer to a vector of length \f$\max(m,n)\f$.
+    ///
+    void apply_long(const Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(const_cast<Scalar *>(x_in), dim);
+        MapVec y(y_out, long_dim());
+        if(mat.rows() >= mat.cols())
+            y.noalias() = mat * x;
+        else
+            y.noalias() = mat.transpose() * x;
+    }
+};
+
+
+#endif // DENSE_SVD_MAT_PROD_H
@@ -0,0 +1,229 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MMAP_SPARSE_GEN_MAT_PROD_H
+#define MMAP_SPARSE_GEN_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <string>
+#include <cstdio>      // std::fopen, std::fwrite, std::fclose
+#include <cstring>     // std::memcpy, std::memcmp
+#include <stdint.h>    // int32_t, int64_t
+#include <stdexcept>   // std::invalid_argument, std::runtime_error
+
+#include <fcntl.h>     // open
+#include <unistd.h>    // close
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the matrix-vector multiplication operation
+/// \f$y=Ax\f$ for a sparse matrix stored in this library's binary on-disk
+/// format, memory-mapped read-only. The SpMV in perform_op() runs
+/// directly over the mapped index and value arrays, so constructing the
+/// object costs a handful of page faults instead of a full parse of a
+/// text format, a cold start proceeds at page-cache speed, and several
+/// processes on the same host opening one file share a single physical
+/// copy of the matrix.
+///
+/// The file layout is a 64-byte header followed by the three arrays of a
+/// compressed column (CSC) matrix:
+///
+///     bytes 0..3    magic "AESM"
+///     bytes 4..7    format version (int32, currently 1)
+///     bytes 8..11   bytes per scalar (int32)
+///     bytes 12..15  bytes per index (int32)
+///     bytes 16..23  rows  (int64)
+///     bytes 24..31  cols  (int64)
+///     bytes 32..39  nnz   (int64)
+///     bytes 40..63  reserved, zero
+///     then          values (nnz scalars), outer index (cols+1 indices),
+///                   inner indices (nnz indices)
+///
+/// The value array starts at offset 64 so that it stays naturally aligned
+/// for every supported scalar type. Files are written with the static
+/// save() member, the converter from an `Eigen::SparseMatrix`.
+///
+/// \tparam Scalar The element type of the matrix.
+///                Currently supported types are `float`, `double` and `long double`.
+///
+template <typename Scalar = double>
+class MMapSparseGenMatProd
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<const Vector> MapConstVec;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+    typedef typename SparseMatrix::StorageIndex StorageIndex;
+    typedef Eigen::Map<const SparseMatrix> MapConstSparseMatrix;
+
+    static const int HEADER_BYTES = 64;
+
+    const std::string filename;
+    char *base;          // start of the mapping
+    size_t bytes;        // size of the mapping
+    int64_t n_rows;
+    int64_t n_cols;
+    int64_t n_nnz;
+    const Scalar *values;
+    const StorageIndex *outer;
+    const StorageIndex *inner;
+
+    // Not copyable: the class owns the mapping
+    MMapSparseGenMatProd(const MMapSparseGenMatProd &);
+    MMapSparseGenMatProd & operator=(const MMapSparseGenMatProd &);
+
+    void fail(const char *msg)
+    {
+        if(base)
+            ::munmap(base, bytes);
+        base = NULL;
+        throw std::invalid_argument(std::string("MMapSparseGenMatProd: ") + msg);
+    }
+
+public:
+    ///
+    /// Constructor to map an existing matrix file.
+    ///
+    /// \param filename_ Path of the matrix file, as written by save().
+    ///
+    MMapSparseGenMatProd(const std::string &filename_) :
+        filename(filename_),
+        base(NULL)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+            throw std::runtime_error("MMapSparseGenMatProd: cannot open matrix file");
+        struct stat st;
+        if(::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MMapSparseGenMatProd: cannot stat matrix file");
+        }
+        bytes = st.st_size;
+        void *p = ::mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED)
+            throw std::runtime_error("MMapSparseGenMatProd: mmap failed");
+        base = static_cast<char *>(p);
+
+        // Validate the header before trusting any offset
+        if(bytes < (size_t) HEADER_BYTES)
+            fail("file too short to hold a header");
+        if(std::memcmp(base, "AESM", 4) != 0)
+            fail("not a sparse matrix file (bad magic)");
+        int32_t version, scalar_bytes, index_bytes;
+        std::memcpy(&version, base + 4, 4);
+        std::memcpy(&scalar_bytes, base + 8, 4);
+        std::memcpy(&index_bytes, base + 12, 4);
+        if(version != 1)
+            fail("unsupported format version");
+        if(scalar_bytes != (int32_t) sizeof(Scalar))
+            fail("scalar type of the file does not match the template parameter");
+        if(index_bytes != (int32_t) sizeof(StorageIndex))
+            fail("index type of the file does not match this build");
+        std::memcpy(&n_rows, base + 16, 8);
+        std::memcpy(&n_cols, base + 24, 8);
+        std::memcpy(&n_nnz, base + 32, 8);
+        if(n_rows < 0 || n_cols < 0 || n_nnz < 0)
+            fail("corrupted header");
+
+        const size_t need = HEADER_BYTES
+            + size_t(n_nnz) * sizeof(Scalar)
+            + (size_t(n_cols) + 1 + size_t(n_nnz)) * sizeof(StorageIndex);
+        if(bytes < need)
+            fail("file truncated");
+
+        values = reinterpret_cast<const Scalar *>(base + HEADER_BYTES);
+        outer = reinterpret_cast<const StorageIndex *>(values + n_nnz);
+        inner = outer + n_cols + 1;
+    }
+
+    ~MMapSparseGenMatProd()
+    {
+        if(base)
+            ::munmap(base, bytes);
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    int rows() { return n_rows; }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    int cols() { return n_cols; }
+    ///
+    /// Return the number of stored nonzero elements.
+    ///
+    int64_t nonzeros() { return n_nnz; }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$
+    /// over the mapped arrays.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapConstVec x(x_in, n_cols);
+        MapVec y(y_out, n_rows);
+        MapConstSparseMatrix mat(n_rows, n_cols, n_nnz, outer, inner, values);
+        y.noalias() = mat * x;
+    }
+
+    ///
+    /// Converter: write an `Eigen::SparseMatrix` to the binary on-disk
+    /// format, to be mapped by later runs.
+    ///
+    /// \param filename_ Path of the file to write.
+    /// \param mat       The matrix to store.
+    ///
+    static void save(const std::string &filename_, const SparseMatrix &mat)
+    {
+        const SparseMatrix *mp = &mat;
+        SparseMatrix compressed;
+        if(!mat.isCompressed())
+        {
+            compressed = mat;
+            compressed.makeCompressed();
+            mp = &compressed;
+        }
+
+        std::FILE *fp = std::fopen(filename_.c_str(), "wb");
+        if(!fp)
+            throw std::runtime_error("MMapSparseGenMatProd: cannot create matrix file");
+
+        char header[HEADER_BYTES] = {0};
+        std::memcpy(header, "AESM", 4);
+        const int32_t version = 1;
+        const int32_t scalar_bytes = sizeof(Scalar);
+        const int32_t index_bytes = sizeof(StorageIndex);
+        const int64_t nrow = mp->rows(), ncol = mp->cols(), nnz = mp->nonZeros();
+        std::memcpy(header + 4, &version, 4);
+        std::memcpy(header + 8, &scalar_bytes, 4);
+        std::memcpy(header + 12, &index_bytes, 4);
+        std::memcpy(header + 16, &nrow, 8);
+        std::memcpy(header + 24, &ncol, 8);
+        std::memcpy(header + 32, &nnz, 8);
+
+        bool ok = std::fwrite(header, 1, HEADER_BYTES, fp) == (size_t) HEADER_BYTES;
+        ok = ok && std::fwrite(mp->valuePtr(), sizeof(Scalar), nnz, fp) == (size_t) nnz;
+        ok = ok && std::fwrite(mp->outerIndexPtr(), sizeof(StorageIndex), ncol + 1, fp) == (size_t)(ncol + 1);
+        ok = ok && std::fwrite(mp->innerIndexPtr(), sizeof(StorageIndex), nnz, fp) == (size_t) nnz;
+        ok = (std::fclose(fp) == 0) && ok;
+        if(!ok)
+            throw std::runtime_error("MMapSparseGenMatProd: write failed");
+    }
+};
+
+
+#endif // MMAP_SPARSE_GEN_MAT_PROD_H
@@ -0,0 +1,123 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PARALLEL_DENSE_GEN_MAT_PROD_H
+#define PARALLEL_DENSE_GEN_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <algorithm>  // std::min, std::max
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///
+/// \ingroup MatOp
+///
+/// This class defines a multi-threaded version of the matrix-vector
+/// multiplication operation on a general real matrix \f$A\f$, i.e.,
+/// calculating \f$y=Ax\f$ for any vector \f$x\f$. The rows of \f$A\f$ are
+/// partitioned into blocks that are processed by different threads, so that
+/// each thread writes a disjoint segment of the result vector. It can be
+/// used in the GenEigsSolver and SymEigsSolver eigen solvers as a drop-in
+/// replacement of DenseGenMatProd when the matrix is large and multiple
+/// CPU cores are available.
+///
+/// This class requires OpenMP to do the actual parallelization. If the
+/// compiler does not support OpenMP, it falls back to the serial
+/// computation, equivalent to DenseGenMatProd.
+///
+template <typename Scalar>
+class ParallelDenseGenMatProd
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<const Matrix> MapMat;
+    typedef Eigen::Map< Eigen::Matrix<Scalar, Eigen::Dynamic, 1> > MapVec;
+
+    typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
+
+    const MapMat mat;
+    int nthread;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat_     An **Eigen** matrix object, whose type can be
+    ///                 `Eigen::Matrix<Scalar, ...>` (e.g. `Eigen::MatrixXd` and
+    ///                 `Eigen::MatrixXf`), or its mapped version
+    ///                 (e.g. `Eigen::Map<Eigen::MatrixXd>`).
+    /// \param nthread_ Number of threads to use. The default value zero means
+    ///                 using all the threads the OpenMP runtime provides.
+    ///
+    ParallelDenseGenMatProd(ConstGenericMatrix &mat_, int nthread_ = 0) :
+        mat(mat_.data(), mat_.rows(), mat_.cols()),
+        nthread(nthread_)
+    {
+#ifdef _OPENMP
+        if(nthread < 1)
+            nthread = omp_get_max_threads();
+#else
+        // Without OpenMP the row blocks are processed serially, but an
+        // explicitly requested block count is still honored
+        if(nthread < 1)
+            nthread = 1;
+#endif
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    int rows() { return mat.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    int cols() { return mat.cols(); }
+    ///
+    /// Return the number of threads used by perform_op().
+    ///
+    int num_threads() { return nthread; }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A * x_in
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        const int nrow = mat.rows();
+        MapVec x(x_in, mat.cols());
+
+        // Each thread computes a contiguous block of rows,
+        // y[begin:(begin + len - 1)] = A[begin:(begin + len - 1), ] * x,
+        // so the writes to y_out never overlap
+        const int nblock = std::min(nthread, nrow);
+        const int block_size = (nrow + nblock - 1) / nblock;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) num_threads(nblock)
+#endif
+        for(int i = 0; i < nblock; i++)
+        {
+            const int begin = i * block_size;
+            // The ceiling division above may leave the trailing blocks
+            // empty, e.g. nrow = 65 with nblock = 64 gives block_size = 2
+            // and only 33 non-empty blocks
+            const int len = std::min(block_size, nrow - begin);
+            if(len > 0)
+            {
+                MapVec y(y_out + begin, len);
+                y.noalias() = mat.middleRows(begin, len) * x;
+            }
+        }
+    }
+};
+
+
+#endif // PARALLEL_DENSE_GEN_MAT_PROD_H
@@ -0,0 +1,137 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PARALLEL_SPARSE_GEN_MAT_PROD_H
+#define PARALLEL_SPARSE_GEN_MAT_PROD_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <vector>     // std::vector
+#include <algorithm>  // std::min, std::max
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///
+/// \ingroup MatOp
+///
+/// This class defines a multi-threaded version of the matrix-vector
+/// multiplication operation on a sparse real matrix \f$A\f$, i.e.,
+/// calculating \f$y=Ax\f$ for any vector \f$x\f$. The constructor converts
+/// the matrix into the row-major storage order, and perform_op() assigns
+/// contiguous row blocks to different threads, each writing a disjoint
+/// segment of the result vector. Row blocks are chosen to contain roughly
+/// the same number of nonzero elements, so that threads receive balanced
+/// work even when the nonzero pattern is uneven.
+///
+/// This class requires OpenMP to do the actual parallelization. If the
+/// compiler does not support OpenMP, it falls back to the serial
+/// computation, equivalent to SparseGenMatProd.
+///
+template <typename Scalar>
+class ParallelSparseGenMatProd
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+    typedef Eigen::SparseMatrix<Scalar, Eigen::RowMajor> RowSparseMatrix;
+
+    RowSparseMatrix mat;
+    int nthread;
+    std::vector<int> block_begin;  // row index where each thread block starts,
+                                   // block_begin[nthread] == rows()
+
+    // Partition the rows into nthread blocks with roughly equal
+    // numbers of nonzero elements
+    void partition_rows()
+    {
+        const int nrow = mat.rows();
+        const int nnz = mat.nonZeros();
+        block_begin.resize(nthread + 1);
+        block_begin[0] = 0;
+
+        const int *outer = mat.outerIndexPtr();
+        int row = 0;
+        for(int i = 1; i < nthread; i++)
+        {
+            // Nonzeros that the first i blocks should roughly cover
+            const double target = double(nnz) * i / nthread;
+            while(row < nrow && outer[row] < target)
+                row++;
+            block_begin[i] = row;
+        }
+        block_begin[nthread] = nrow;
+    }
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat_     An **Eigen** sparse matrix object, whose type is
+    ///                 `Eigen::SparseMatrix<Scalar, ...>`.
+    /// \param nthread_ Number of threads to use. The default value zero means
+    ///                 using all the threads the OpenMP runtime provides.
+    ///
+    ParallelSparseGenMatProd(const SparseMatrix &mat_, int nthread_ = 0) :
+        mat(mat_),
+        nthread(nthread_)
+    {
+#ifdef _OPENMP
+        if(nthread < 1)
+            nthread = omp_get_max_threads();
+#else
+        // Without OpenMP the row blocks are processed serially, but an
+        // explicitly requested block count is still honored
+        if(nthread < 1)
+            nthread = 1;
+#endif
+        nthread = std::min(nthread, std::max(1, int(mat.rows())));
+        partition_rows();
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    int rows() { return mat.rows(); }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    int cols() { return mat.cols(); }
+    ///
+    /// Return the number of threads used by perform_op().
+    ///
+    int num_threads() { return nthread; }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = A * x_in
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in, mat.cols());
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) num_threads(nthread)
+#endif
+        for(int i = 0; i < nthread; i++)
+        {
+            const int begin = block_begin[i];
+            const int len = block_begin[i + 1] - begin;
+            if(len > 0)
+            {
+                MapVec y(y_out + begin, len);
+                y.noalias() = mat.middleRows(begin, len) * x;
+            }
+        }
+    }
+};
+
+
+#endif // PARALLEL_SPARSE_GEN_MAT_PROD_H
@@ -18,25 +18,40 @@
 /// \f$x\f$. It is mainly used in the GenEigsSolver and
 /// SymEigsSolver eigen solvers.
 ///
-template <typename Scalar>
+/// \tparam Scalar The element type of the matrix.
+/// \tparam Flags  Either `Eigen::ColMajor` (default) or `Eigen::RowMajor`,
+///                indicating the storage layout of the underlying sparse
+///                matrix, so that matrices assembled or mapped in row-major
+///                (CSR) form can be used directly without a layout
+///                conversion.
+///
+template <typename Scalar, int Flags = Eigen::ColMajor>
 class SparseGenMatProd
 {
 private:
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
     typedef Eigen::Map<Vector> MapVec;
-    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+    typedef Eigen::SparseMatrix<Scalar, Flags> SparseMatrix;
+
+    typedef const Eigen::Ref<const SparseMatrix> ConstGenericSparseMatrix;
 
-    const SparseMatrix &mat;
+    ConstGenericSparseMatrix mat;
 
 public:
     ///
     /// Constructor to create the matrix operation object.
     ///
-    /// \param mat_ An **Eigen** sparse matrix object, whose type is
-    /// `Eigen::SparseMatrix<Scalar, ...>`.
+    /// \param mat_ An **Eigen** sparse matrix object in compressed form,
+    /// whose type can be `Eigen::SparseMatrix<Scalar, ...>` or its mapped
+    /// version over externally owned index and value buffers (e.g.
+    /// `Eigen::Map<Eigen::SparseMatrix<Scalar> >`). Objects whose layout
+    /// matches the `Flags` template parameter are referenced without
+    /// copying; any other sparse expression is evaluated once into a
+    /// matrix owned by this object.
     ///
-    SparseGenMatProd(SparseMatrix &mat_) :
-        mat(mat_)
+    template <typename Derived>
+    SparseGenMatProd(const Eigen::SparseMatrixBase<Derived> &mat_) :
+        mat(mat_.derived())
     {}
 
     ///
@@ -61,6 +76,24 @@ public:
         MapVec y(y_out, mat.rows());
         y.noalias() = mat * x;
     }
+
+    ///
+    /// Perform the matrix-matrix multiplication operation \f$Y=AX\f$ on
+    /// `ncols` vectors at once, so that the sparse matrix is traversed only
+    /// once for the whole block. It is used by the block eigen solvers.
+    ///
+    /// \param x_in  Pointer to the \f$X\f$ matrix, stored in column-major order.
+    /// \param y_out Pointer to the \f$Y\f$ matrix, stored in column-major order.
+    /// \param ncols Number of columns of \f$X\f$ and \f$Y\f$.
+    ///
+    // Y_out = A * X_in
+    void perform_op(Scalar *x_in, Scalar *y_out, int ncols)
+    {
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+        Eigen::Map<Matrix> x(x_in, mat.cols(), ncols);
+        Eigen::Map<Matrix> y(y_out, mat.rows(), ncols);
+        y.noalias() = mat * x;
+    }
 };
 
 
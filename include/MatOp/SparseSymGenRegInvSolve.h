@@ -0,0 +1,103 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SPARSE_SYM_GEN_REG_INV_SOLVE_H
+#define SPARSE_SYM_GEN_REG_INV_SOLVE_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <stdexcept>
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the regular inverse mode operation for the
+/// generalized eigen problem \f$Ax=\lambda Bx\f$ with sparse symmetric
+/// \f$A\f$ and sparse positive definite \f$B\f$: calculating
+/// \f$y=B^{-1}Ax\f$ for any vector \f$x\f$, together with the plain
+/// \f$B\f$ product needed for the \f$B\f$-inner products of the Lanczos
+/// recurrence. The sparse Cholesky factorization of \f$B\f$ is computed
+/// once in the constructor and reused by every perform_op() call, so
+/// \f$B^{-1}\f$ is never formed and the sparsity of both matrices is
+/// preserved. It is mainly used in the SymGEigsSolver eigen solver.
+///
+template <typename Scalar>
+class SparseSymGenRegInvSolve
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+
+    const SparseMatrix &mat_A;
+    const SparseMatrix &mat_B;
+    const int dim_n;
+    Eigen::SimplicialLLT<SparseMatrix> solver;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param A_ An **Eigen** sparse symmetric matrix object.
+    /// \param B_ An **Eigen** sparse positive definite matrix object,
+    ///           which is factorized here and cached for all later
+    ///           operations.
+    ///
+    SparseSymGenRegInvSolve(SparseMatrix &A_, SparseMatrix &B_) :
+        mat_A(A_),
+        mat_B(B_),
+        dim_n(A_.rows())
+    {
+        if(A_.rows() != A_.cols() || B_.rows() != B_.cols() || A_.rows() != B_.rows())
+            throw std::invalid_argument("SparseSymGenRegInvSolve: A and B must be square matrices of the same size");
+
+        solver.compute(mat_B);
+        if(solver.info() != Eigen::Success)
+            throw std::invalid_argument("SparseSymGenRegInvSolve: Cholesky factorization of B failed, B must be positive definite");
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrices.
+    ///
+    int rows() { return dim_n; }
+    ///
+    /// Return the number of columns of the underlying matrices.
+    ///
+    int cols() { return dim_n; }
+
+    ///
+    /// Perform the matrix operation \f$y=B^{-1}Ax\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = inv(B) * A * x_in
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in,  dim_n);
+        MapVec y(y_out, dim_n);
+        y.noalias() = solver.solve(mat_A * x);
+    }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Bx\f$,
+    /// used by the solver to form the \f$B\f$-inner products.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = B * x_in
+    void perform_B_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in,  dim_n);
+        MapVec y(y_out, dim_n);
+        y.noalias() = mat_B * x;
+    }
+};
+
+
+#endif // SPARSE_SYM_GEN_REG_INV_SOLVE_H
@@ -0,0 +1,108 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SPARSE_SYM_GEN_SHIFT_SOLVE_H
+#define SPARSE_SYM_GEN_SHIFT_SOLVE_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <stdexcept>
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the shift-invert mode operation for the generalized
+/// eigen problem \f$Ax=\lambda Bx\f$ with sparse symmetric \f$A\f$ and
+/// sparse positive definite \f$B\f$: calculating
+/// \f$y=(A-\sigma B)^{-1}Bx\f$ for any real \f$\sigma\f$ and vector
+/// \f$x\f$, together with the plain \f$B\f$ product needed for the
+/// \f$B\f$-inner products of the Lanczos recurrence. The sparse Cholesky
+/// factorization of \f$A-\sigma B\f$ is computed once in set_shift() and
+/// reused by every perform_op() call. It is mainly used in the
+/// SymGEigsShiftSolver eigen solver.
+///
+template <typename Scalar>
+class SparseSymGenShiftSolve
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+
+    const SparseMatrix &mat_A;
+    const SparseMatrix &mat_B;
+    const int dim_n;
+    Eigen::SimplicialLDLT<SparseMatrix> solver;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param A_ An **Eigen** sparse symmetric matrix object.
+    /// \param B_ An **Eigen** sparse positive definite matrix object.
+    ///
+    SparseSymGenShiftSolve(SparseMatrix &A_, SparseMatrix &B_) :
+        mat_A(A_),
+        mat_B(B_),
+        dim_n(A_.rows())
+    {
+        if(A_.rows() != A_.cols() || B_.rows() != B_.cols() || A_.rows() != B_.rows())
+            throw std::invalid_argument("SparseSymGenShiftSolve: A and B must be square matrices of the same size");
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrices.
+    ///
+    int rows() { return dim_n; }
+    ///
+    /// Return the number of columns of the underlying matrices.
+    ///
+    int cols() { return dim_n; }
+
+    ///
+    /// Set the real shift \f$\sigma\f$ and factorize \f$A-\sigma B\f$.
+    ///
+    void set_shift(Scalar sigma)
+    {
+        SparseMatrix shifted = mat_A - sigma * mat_B;
+        solver.compute(shifted);
+        if(solver.info() != Eigen::Success)
+            throw std::invalid_argument("SparseSymGenShiftSolve: factorization failed with the given shift");
+    }
+
+    ///
+    /// Perform the shift-solve operation \f$y=(A-\sigma B)^{-1}Bx\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = inv(A - sigma * B) * B * x_in
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in,  dim_n);
+        MapVec y(y_out, dim_n);
+        y.noalias() = solver.solve(mat_B * x);
+    }
+
+    ///
+    /// Perform the matrix-vector multiplication operation \f$y=Bx\f$,
+    /// used by the solver to form the \f$B\f$-inner products.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = B * x_in
+    void perform_B_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in,  dim_n);
+        MapVec y(y_out, dim_n);
+        y.noalias() = mat_B * x;
+    }
+};
+
+
+#endif // SPARSE_SYM_GEN_SHIFT_SOLVE_H
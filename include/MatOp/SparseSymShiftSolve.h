@@ -0,0 +1,91 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SPARSE_SYM_SHIFT_SOLVE_H
+#define SPARSE_SYM_SHIFT_SOLVE_H
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+#include <stdexcept>
+
+///
+/// \ingroup MatOp
+///
+/// This class defines the shift-solve operation on a sparse real symmetric
+/// matrix \f$A\f$, i.e., calculating \f$y=(A-\sigma I)^{-1}x\f$ for any real
+/// \f$\sigma\f$ and vector \f$x\f$. The sparse Cholesky factorization of
+/// \f$A-\sigma I\f$ is computed once in set_shift() and reused by every
+/// perform_op() call, so the cost per solve is only a pair of sparse
+/// triangular solves. It is mainly used in the SymEigsShiftSolver eigen solver.
+///
+template <typename Scalar>
+class SparseSymShiftSolve
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Vector> MapVec;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+
+    const SparseMatrix &mat;
+    const int dim_n;
+    Eigen::SimplicialLDLT<SparseMatrix> solver;
+
+public:
+    ///
+    /// Constructor to create the matrix operation object.
+    ///
+    /// \param mat_ An **Eigen** sparse matrix object, whose type is
+    /// `Eigen::SparseMatrix<Scalar, ...>`.
+    ///
+    SparseSymShiftSolve(SparseMatrix &mat_) :
+        mat(mat_),
+        dim_n(mat_.rows())
+    {
+        if(mat_.rows() != mat_.cols())
+            throw std::invalid_argument("SparseSymShiftSolve: matrix must be square");
+    }
+
+    ///
+    /// Return the number of rows of the underlying matrix.
+    ///
+    int rows() { return dim_n; }
+    ///
+    /// Return the number of columns of the underlying matrix.
+    ///
+    int cols() { return dim_n; }
+
+    ///
+    /// Set the real shift \f$\sigma\f$ and factorize \f$A-\sigma I\f$.
+    ///
+    void set_shift(Scalar sigma)
+    {
+        SparseMatrix I(dim_n, dim_n);
+        I.setIdentity();
+
+        SparseMatrix shifted = mat - sigma * I;
+        solver.compute(shifted);
+        if(solver.info() != Eigen::Success)
+            throw std::invalid_argument("SparseSymShiftSolve: factorization failed with the given shift");
+    }
+
+    ///
+    /// Perform the shift-solve operation \f$y=(A-\sigma I)^{-1}x\f$.
+    ///
+    /// \param x_in  Pointer to the \f$x\f$ vector.
+    /// \param y_out Pointer to the \f$y\f$ vector.
+    ///
+    // y_out = inv(A - sigma * I) * x_in
+    void perform_op(Scalar *x_in, Scalar *y_out)
+    {
+        MapVec x(x_in,  dim_n);
+        MapVec y(y_out, dim_n);
+        y.noalias() = solver.solve(x);
+    }
+};
+
+
+#endif // SPARSE_SYM_SHIFT_SOLVE_H
@@ -0,0 +1,215 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PARTIAL_SVD_SOLVER_H
+#define PARTIAL_SVD_SOLVER_H
+
+#include <Eigen/Core>
+#include <cmath>      // std::sqrt
+#include <algorithm>  // std::min
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::logic_error
+
+#include "SymEigsSolver.h"
+#include "MatOp/DenseSVDMatProd.h"
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class computes a partial singular value decomposition of a
+/// rectangular \f$m\times n\f$ matrix \f$A\f$: the largest \f$k\f$
+/// singular values and the associated left and right singular vectors,
+/// \f$A\approx USV'\f$.
+///
+/// The computation is layered on SymEigsSolver, using the fact that the
+/// squared singular values of \f$A\f$ are the eigenvalues of the Gram
+/// matrix \f$A'A\f$ (or \f$AA'\f$, whichever is smaller). Crucially, the
+/// Gram matrix is **never formed**: the matrix operation object applies
+/// the two factors one after the other, so for a sparse \f$A\f$ each
+/// iteration costs two passes over its nonzeros instead of a product
+/// with a dense (or catastrophically filled) \f$\min(m,n)^2\f$ matrix.
+/// The singular vectors on the short side of \f$A\f$ are the converged
+/// eigenvectors, and the vectors on the long side are recovered as
+/// \f$u=Av/\sigma\f$ (respectively \f$v=A'u/\sigma\f$).
+///
+/// The matrix operation class is given by the `OpType` template
+/// parameter; use DenseSVDMatProd for a dense matrix and SparseSVDMatProd
+/// for an `Eigen::SparseMatrix`, or supply a matrix-free implementation
+/// of the same public member functions.
+///
+/// \tparam Scalar The element type of the matrix.
+///                Currently supported types are `float`, `double` and `long double`.
+/// \tparam OpType The name of the matrix operation class, implementing the
+///                Gram product and the long-side application as in
+///                DenseSVDMatProd.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <PartialSVDSolver.h>  // Also includes <MatOp/DenseSVDMatProd.h>
+/// #include <iostream>
+///
+/// int main()
+/// {
+///     // A tall matrix whose top three singular triplets are wanted
+///     Eigen::MatrixXd A = Eigen::MatrixXd::Random(1000, 100);
+///
+///     DenseSVDMatProd<double> op(A);
+///     PartialSVDSolver< double, DenseSVDMatProd<double> > svds(&op, 3, 10);
+///     int nconv = svds.compute();
+///
+///     Eigen::VectorXd S = svds.singular_values();
+///     Eigen::MatrixXd U = svds.matrix_U(nconv);
+///     Eigen::MatrixXd V = svds.matrix_V(nconv);
+///
+///     std::cout << "Singular values found:\n" << S << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template < typename Scalar = double,
+           typename OpType = DenseSVDMatProd<double> >
+class PartialSVDSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+    OpType *op;          // object applying the Gram operator and the
+                         // long-side factor of A
+    const int ncomp;     // number of singular triplets requested
+
+    SymEigsSolver<Scalar, LARGEST_ALGE, OpType> eigs;  // the underlying
+                                                       // symmetric solver
+
+    int nconv;           // number of converged singular triplets
+    Vector sval;         // converged singular values
+    Matrix short_vec;    // singular vectors on the short side of A
+    Matrix long_vec;     // singular vectors on the long side of A
+    bool computed;       // whether compute() has been run
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op_    Pointer to the matrix operation object, typically an
+    ///               instance of DenseSVDMatProd or SparseSVDMatProd
+    ///               wrapping the matrix \f$A\f$.
+    /// \param ncomp_ Number of singular triplets requested. This should
+    ///               satisfy \f$1\le ncomp \le \min(m,n)-1\f$.
+    /// \param ncv_   Parameter that controls the convergence speed, as in
+    ///               SymEigsSolver. This parameter must satisfy
+    ///               \f$ncomp < ncv \le \min(m,n)\f$, and is advised to
+    ///               take \f$ncv \ge 2\cdot ncomp\f$.
+    ///
+    PartialSVDSolver(OpType *op_, int ncomp_, int ncv_) :
+        op(op_),
+        ncomp(ncomp_),
+        eigs(op_, ncomp_, ncv_),
+        nconv(0),
+        computed(false)
+    {}
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the underlying eigen solver.
+    ///
+    /// \return Number of converged singular triplets.
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        eigs.init();
+        nconv = eigs.compute(maxit, tol);
+
+        // Eigenvalues of the Gram operator are the squared singular
+        // values; clip the tiny negative values produced by rounding
+        sval.resize(nconv);
+        eigs.eigenvalues(sval.data());
+        sval = sval.cwiseMax(Scalar(0)).cwiseSqrt();
+
+        short_vec = eigs.eigenvectors(nconv);
+
+        // Recover the long-side singular vectors as A * v / sigma
+        // (A' * u / sigma when A is wide)
+        const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        long_vec.resize(op->long_dim(), nconv);
+        for(int j = 0; j < nconv; j++)
+        {
+            op->apply_long(&short_vec(0, j), &long_vec(0, j));
+            if(nconv > 0 && sval[j] > eps * sval[0])
+                long_vec.col(j) /= sval[j];
+        }
+
+        computed = true;
+        return nconv;
+    }
+
+    ///
+    /// Returning the converged singular values, in decreasing order.
+    ///
+    Vector singular_values()
+    {
+        if(!computed)
+            throw std::logic_error("PartialSVDSolver: need to call compute() first");
+
+        return sval;
+    }
+
+    ///
+    /// Returning the left singular vectors, i.e. the \f$m\times nvec\f$
+    /// matrix \f$U\f$.
+    ///
+    /// \param nvec The number of singular vectors to return. It is capped
+    ///             by the number of converged singular triplets.
+    ///
+    Matrix matrix_U(int nvec)
+    {
+        if(!computed)
+            throw std::logic_error("PartialSVDSolver: need to call compute() first");
+
+        nvec = std::min(nvec, nconv);
+        const Matrix &U = op->tall() ? long_vec : short_vec;
+        return U.leftCols(nvec);
+    }
+
+    ///
+    /// Returning the right singular vectors, i.e. the \f$n\times nvec\f$
+    /// matrix \f$V\f$.
+    ///
+    /// \param nvec The number of singular vectors to return. It is capped
+    ///             by the number of converged singular triplets.
+    ///
+    Matrix matrix_V(int nvec)
+    {
+        if(!computed)
+            throw std::logic_error("PartialSVDSolver: need to call compute() first");
+
+        nvec = std::min(nvec, nconv);
+        const Matrix &V = op->tall() ? short_vec : long_vec;
+        return V.leftCols(nvec);
+    }
+
+    ///
+    /// Returning the number of iterations used by the underlying eigen
+    /// solver.
+    ///
+    int num_iterations() { return eigs.num_iterations(); }
+
+    ///
+    /// Returning the number of Gram operator applications used in the
+    /// computation; each one costs one product with \f$A\f$ and one with
+    /// \f$A'\f$.
+    ///
+    int num_operations() { return eigs.num_operations(); }
+};
+
+
+#endif // PARTIAL_SVD_SOLVER_H
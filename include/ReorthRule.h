@@ -0,0 +1,45 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef REORTH_RULE_H
+#define REORTH_RULE_H
+
+///
+/// \file ReorthRule.h
+///
+/// This file defines the enumeration type for the reorthogonalization
+/// strategy used in the Arnoldi factorization. The strategy decides when
+/// the new residual vector is corrected against the basis, trading the
+/// cost of the correction passes against the loss of orthogonality,
+/// which in turn causes spurious restarts. It can be selected at run
+/// time through the set_reorth_rule() member of the solvers.
+///
+
+///
+/// The enumeration of reorthogonalization strategies.
+///
+enum REORTH_RULE
+{
+    REORTH_STANDARD = 0,  ///< Test the inner product \f$\langle v_1,f\rangle\f$ against the
+                          ///< precision parameter and perform one correction pass when the
+                          ///< test fails. This is the default, and the cheapest strategy
+                          ///< that maintains orthogonality for well-behaved operators.
+
+    REORTH_NONE,          ///< Never correct the residual. Only safe for very well
+                          ///< conditioned operators and short factorizations.
+
+    REORTH_DGKS,          ///< Iterated classical Gram-Schmidt with the eta test of
+                          ///< Daniel, Gragg, Kaufman and Stewart: reorthogonalize
+                          ///< while the correction removes a substantial part of the
+                          ///< residual norm, up to a small number of passes. The most
+                          ///< robust choice for ill-conditioned operators.
+
+    REORTH_FULL           ///< Perform one unconditional correction pass on every step
+                          ///< of the factorization.
+};
+
+
+#endif // REORTH_RULE_H
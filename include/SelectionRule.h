@@ -236,9 +236,18 @@ private:
     std::vector<PairType> pair_sort;
 
 public:
-    SortEigenvalue(const T* start, int size) :
-        pair_sort(size)
+    SortEigenvalue() {}
+
+    SortEigenvalue(const T* start, int size)
+    {
+        compute(start, size);
+    }
+
+    // Sort a new set of values. When the object is reused with the same
+    // size, as the solvers do on every restart, no memory is allocated
+    void compute(const T* start, int size)
     {
+        pair_sort.resize(size);
         for(int i = 0; i < size; i++)
         {
             pair_sort[i].first = SortingTarget<T, SelectionRule>::get(start[i]);
@@ -248,11 +257,20 @@ public:
         std::sort(pair_sort.begin(), pair_sort.end(), comp);
     }
 
+    // Write the order index into a caller-supplied buffer of at least
+    // `size` elements, without allocating
+    void index(int *dest)
+    {
+        const int size = pair_sort.size();
+        for(int i = 0; i < size; i++)
+            dest[i] = pair_sort[i].second;
+    }
+
     std::vector<int> index()
     {
         std::vector<int> ind(pair_sort.size());
-        for(unsigned int i = 0; i < ind.size(); i++)
-            ind[i] = pair_sort[i].second;
+        if(!ind.empty())
+            index(&ind[0]);
 
         return ind;
     }
@@ -0,0 +1,132 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <vector>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+///
+/// \ingroup EigenSolver
+///
+/// The no-op statistics policy used by the solvers by default. All its
+/// member functions are empty and are guarded by the compile-time
+/// constant `enabled`, so the instrumentation points in the solvers are
+/// dead code that the compiler removes, and the hot path stays exactly
+/// as it was.
+///
+template <typename Scalar>
+class NullSolverStats
+{
+public:
+    enum { enabled = 0 };
+
+    static double wall_time() { return 0.0; }
+    void reset() {}
+    void add_op_time(double) {}
+    void add_reorth_time(double) {}
+    void add_restart_time(double) {}
+    void add_ritz_time(double) {}
+    void reorth_hit() {}
+    void restart_hit() {}
+    void iteration(int, int, Scalar) {}
+};
+
+///
+/// \ingroup EigenSolver
+///
+/// The recording statistics policy. Passing this class as the
+/// `StatsPolicy` template parameter of a solver makes it accumulate
+/// per-phase wall time and event counts during compute(), which tells
+/// apart a solve dominated by perform_op() from one dominated by the
+/// reorthogonalization corrections, the QR sweeps of the restarts, or
+/// the Ritz pair computation:
+///
+/// \code{.cpp}
+/// SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+///               SolverStats<double>> eigs(&op, nev, ncv);
+/// eigs.init();
+/// eigs.compute();
+/// std::cout << "time in perform_op: " << eigs.stats().time_op << std::endl;
+/// \endcode
+///
+/// A per-iteration callback can also be installed through the
+/// `iter_callback` member before calling compute(); it receives the
+/// iteration number, the number of converged Ritz values, and the
+/// largest residual norm among the wanted Ritz pairs.
+///
+template <typename Scalar>
+class SolverStats
+{
+public:
+    enum { enabled = 1 };
+
+    double time_op;       ///< Wall time spent in perform_op(), in seconds
+    double time_reorth;   ///< Wall time spent in the reorthogonalization
+                          ///< correction branch of the factorization
+    double time_restart;  ///< Wall time spent in the QR sweeps of restart()
+    double time_ritz;     ///< Wall time spent in retrieve_ritzpair()
+    int nreorth;          ///< Number of reorthogonalization corrections
+    int nrestart;         ///< Number of implicit restarts
+    std::vector<Scalar> resid_history;  ///< Largest residual norm among the
+                                        ///< wanted Ritz pairs, per iteration
+
+    /// Optional callback invoked once per iteration with the iteration
+    /// number, the number of converged Ritz values, and the largest
+    /// residual norm among the wanted Ritz pairs. NULL by default.
+    void (*iter_callback)(int iter, int nconv, Scalar resid);
+
+    SolverStats() : iter_callback(NULL) { reset(); }
+
+    /// Clear all accumulated times, counts and the residual history.
+    /// The callback is kept. Called by the solver from init().
+    void reset()
+    {
+        time_op = time_reorth = time_restart = time_ritz = 0.0;
+        nreorth = nrestart = 0;
+        resid_history.clear();
+    }
+
+    /// Current wall time in seconds, used by the solvers to time phases
+    static double wall_time()
+    {
+#ifdef _WIN32
+        LARGE_INTEGER time, freq;
+        if(!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&time))
+            return 0.0;
+        return (double)time.QuadPart / freq.QuadPart;
+#else
+        struct timeval time;
+        if(gettimeofday(&time, NULL))
+            return 0.0;
+        return (double)time.tv_sec + (double)time.tv_usec * 1e-6;
+#endif
+    }
+
+    void add_op_time(double t)      { time_op += t; }
+    void add_reorth_time(double t)  { time_reorth += t; }
+    void add_restart_time(double t) { time_restart += t; }
+    void add_ritz_time(double t)    { time_ritz += t; }
+    void reorth_hit()  { nreorth++; }
+    void restart_hit() { nrestart++; }
+
+    void iteration(int iter, int nconv, Scalar resid)
+    {
+        resid_history.push_back(resid);
+        if(iter_callback)
+            iter_callback(iter, nconv, resid);
+    }
+};
+
+
+#endif // SOLVER_STATS_H
@@ -0,0 +1,521 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SYM_EIGS_BLOCK_SOLVER_H
+#define SYM_EIGS_BLOCK_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <vector>     // std::vector
+#include <cmath>      // std::abs, std::pow
+#include <algorithm>  // std::min, std::copy
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+
+#include "SelectionRule.h"
+#include "MatOp/DenseGenMatProd.h"
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a block Lanczos eigen solver for real symmetric
+/// matrices. The background information documented in the SymEigsSolver
+/// class also applies here; the difference is that the Krylov basis grows
+/// by blocks of `bsize` vectors at a time, so the matrix operation class
+/// needs to implement the batched interface
+/// `perform_op(Scalar *x_in, Scalar *y_out, int ncols)`, computing
+/// \f$Y=AX\f$ for `ncols` vectors in one call, as DenseGenMatProd and
+/// SparseGenMatProd do. A single level-3 product over a block of vectors
+/// typically runs several times faster than the equivalent sequence of
+/// matrix-vector products, and block iterations also behave better on
+/// matrices with clustered eigenvalues.
+///
+/// When the subspace is full, the solver performs the Rayleigh-Ritz
+/// projection and restarts from the wanted Ritz vectors augmented by the
+/// current residual block (a thick restart), so no progress is lost
+/// between cycles.
+///
+/// \tparam Scalar        The element type of the matrix.
+///                       Currently supported types are `float`, `double` and `long double`.
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the requested eigenvalues, for example `LARGEST_MAGN`
+///                       to retrieve eigenvalues with the largest magnitude.
+///                       The full list of enumeration values can be found in
+///                       SelectionRule.h .
+/// \tparam OpType        The name of the matrix operation class. Users could either
+///                       use the DenseGenMatProd wrapper class, or define their
+///                       own that implements the batched
+///                       `perform_op(Scalar *, Scalar *, int)` member function.
+///
+template < typename Scalar = double,
+           int SelectionRule = LARGEST_MAGN,
+           typename OpType = DenseGenMatProd<double> >
+class SymEigsBlockSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
+    typedef Eigen::Array<bool, Eigen::Dynamic, 1> BoolArray;
+    typedef Eigen::SelfAdjointEigenSolver<Matrix> EigenSolver;
+
+    OpType *op;          // object to conduct matrix operation,
+                         // e.g. matrix-vector product
+    const int dim_n;     // dimension of matrix A
+    const int nev;       // number of eigenvalues requested
+    const int ncv;       // size of the projection subspace
+    const int bsize;     // number of vectors in each block
+    int nmatop;          // number of matrix operations called
+    int niter;           // number of restarting iterations
+
+    Matrix fac_V;        // orthonormal basis of the subspace
+    Matrix fac_H;        // projected matrix, H = V'AV
+    Matrix fac_F;        // residual block, AV = VH + F * E'
+    int dim_m;           // current size of the subspace. The expansion stops
+                         // early when the remaining room cannot hold a whole
+                         // residual block, since truncating the block would
+                         // lose part of the residual coupling and destroy
+                         // the factorization structure, so dim_m may be
+                         // slightly smaller than ncv in some cycles
+    int last_bsize;      // number of valid columns of fac_F, i.e. the size of
+                         // the most recent block; may be smaller than bsize
+                         // when the subspace is nearly full or when dependent
+                         // columns have been deflated from the block
+
+    Vector ritz_val;     // ritz values
+    Matrix ritz_vec;     // ritz vectors of the projected matrix
+    BoolArray ritz_conv; // indicator of the convergence of ritz values
+
+    const Scalar prec;   // precision parameter used to test convergence
+                         // prec = epsilon^(2/3)
+                         // epsilon is the machine precision,
+                         // e.g. ~= 1e-16 for the "double" type
+
+    // Orthonormalize the nb columns of B against the first ncols columns
+    // of fac_V (two classical Gram-Schmidt passes each), and then against
+    // each other. Columns that become negligible in the process are linearly
+    // dependent on the basis and carry no new information, so they are
+    // dropped and the block shrinks -- the saved room is then spent on
+    // deeper recurrence steps instead of noise directions. Returns the
+    // number of columns kept; if all columns are dropped, a random vector
+    // is inserted so that the iteration can always continue.
+    int orth_block(Matrix &B, int ncols, int nb)
+    {
+        int rank = 0;
+        for(int j = 0; j < nb; j++)
+        {
+            Scalar norm = B.col(j).norm();
+            if(norm < prec)
+                continue;
+            if(j > rank)
+                B.col(rank) = B.col(j);
+            B.col(rank) /= norm;
+
+            for(int pass = 0; pass < 2; pass++)
+            {
+                if(ncols > 0)
+                {
+                    B.col(rank).noalias() -= fac_V.leftCols(ncols) *
+                        (fac_V.leftCols(ncols).transpose() * B.col(rank));
+                }
+                for(int i = 0; i < rank; i++)
+                    B.col(rank) -= B.col(i).dot(B.col(rank)) * B.col(i);
+            }
+
+            norm = B.col(rank).norm();
+            // After normalization the remaining norm measures the angle
+            // between the column and the current subspace; tiny values
+            // indicate linear dependence and the column is dropped
+            if(norm < prec)
+                continue;
+            B.col(rank) /= norm;
+            rank++;
+        }
+
+        if(rank == 0)
+        {
+            // Complete breakdown: continue from a random direction
+            B.col(0) = Vector::Random(dim_n);
+            B.col(0).array() -= 0.5;
+            for(int pass = 0; pass < 2; pass++)
+            {
+                if(ncols > 0)
+                {
+                    B.col(0).noalias() -= fac_V.leftCols(ncols) *
+                        (fac_V.leftCols(ncols).transpose() * B.col(0));
+                }
+            }
+            B.col(0).normalize();
+            rank = 1;
+        }
+
+        return rank;
+    }
+
+    // Grow the basis from from_k columns to to_m columns, one block at a
+    // time. Each new block is the current residual block orthonormalized
+    // against the existing basis, and the projected matrix fac_H is
+    // extended accordingly.
+    void factorize_from(int from_k, int to_m)
+    {
+        if(to_m <= from_k) return;
+
+        Matrix B(dim_n, bsize), W(dim_n, bsize);
+        int cur = from_k;
+        while(cur < to_m)
+        {
+            const int nreq = std::min(bsize, last_bsize);
+            // The whole residual block must enter the basis; a truncated
+            // block would lose part of the coupling AV - VH
+            if(to_m - cur < nreq)
+                break;
+
+            B.leftCols(nreq) = fac_F.leftCols(nreq);
+            const int nb = orth_block(B, cur, nreq);
+            fac_V.middleCols(cur, nb).noalias() = B.leftCols(nb);
+
+            // W = A * [new block], a single batched operation
+            op->perform_op(&fac_V(0, cur), W.data(), nb);
+            nmatop += nb;
+
+            // h = V' * W extends the projected matrix by nb columns;
+            // the rows below the diagonal block follow by symmetry
+            Matrix h = fac_V.leftCols(cur + nb).transpose() * W.leftCols(nb);
+            fac_H.block(0, cur, cur + nb, nb).noalias() = h;
+            fac_H.block(cur, 0, nb, cur).noalias() = h.topRows(cur).transpose();
+
+            // New residual block F = W - V * h
+            fac_F.leftCols(nb).noalias() = W.leftCols(nb) - fac_V.leftCols(cur + nb) * h;
+
+            last_bsize = nb;
+            cur += nb;
+        }
+
+        dim_m = cur;
+    }
+
+    // Restart with the k wanted Ritz vectors as the new leading basis
+    void restart(int k)
+    {
+        // Keep enough room for at least one whole residual block,
+        // otherwise the expansion could not make any progress
+        k = std::min(k, ncv - std::min(bsize, last_bsize));
+        if(k < nev || k >= dim_m)
+            return;
+
+        // New basis X = V * S, where S holds the k wanted Ritz vectors of
+        // the projected matrix; X is orthonormal since S is.
+        // A * X = X * diag(theta) + F * S_bottom, so the Ritz restart keeps
+        // the factorization structure with the same residual block fac_F.
+        Matrix Vs = fac_V.leftCols(dim_m) * ritz_vec.topLeftCorner(dim_m, k);
+        fac_V.leftCols(k).noalias() = Vs;
+
+        fac_H.setZero();
+        fac_H.topLeftCorner(k, k).diagonal() = ritz_val.head(k);
+
+        factorize_from(k, ncv);
+        retrieve_ritzpair();
+    }
+
+    // Calculate the number of converged Ritz values
+    int num_converged(Scalar tol)
+    {
+        // thresh = tol * max(prec, abs(theta)), theta for ritz value
+        Array thresh = tol * ritz_val.head(nev).array().abs().max(prec);
+        // Residual norm of the i-th Ritz pair is
+        // ||F * s_i[bottom]||, with s_i the corresponding Ritz vector of H
+        Array resid(nev);
+        for(int i = 0; i < nev; i++)
+        {
+            resid[i] = (fac_F.leftCols(last_bsize) *
+                        ritz_vec.col(i).segment(dim_m - last_bsize, last_bsize)).norm();
+        }
+        // Converged "wanted" ritz values
+        ritz_conv = (resid < thresh);
+
+        return ritz_conv.cast<int>().sum();
+    }
+
+    // Return the adjusted nev for restarting
+    int nev_adjusted(int nconv)
+    {
+        // Same strategy as in SymEigsSolver, rounded up so that the
+        // remaining space is a whole number of blocks
+        int nev_new = nev + std::min(nconv, (ncv - nev) / 2);
+        if(nev == 1 && ncv >= 6)
+            nev_new = ncv / 2;
+        else if(nev == 1 && ncv > 2)
+            nev_new = 2;
+
+        if(nev_new > ncv - 1)
+            nev_new = ncv - 1;
+
+        return nev_new;
+    }
+
+    // Retrieve and sort ritz values and ritz vectors
+    void retrieve_ritzpair()
+    {
+        EigenSolver decomp(fac_H.topLeftCorner(dim_m, dim_m));
+        Vector evals = decomp.eigenvalues();
+        Matrix evecs = decomp.eigenvectors();
+
+        SortEigenvalue<Scalar, SelectionRule> sorting(evals.data(), evals.size());
+        std::vector<int> ind = sorting.index();
+
+        // For BOTH_ENDS, the eigenvalues are sorted according
+        // to the LARGEST_ALGE rule, so we need to move those smallest
+        // values to the left. See SymEigsSolver::retrieve_ritzpair()
+        // for the details.
+        if(SelectionRule == BOTH_ENDS)
+        {
+            std::vector<int> ind_copy(ind);
+            for(int i = 0; i < dim_m; i++)
+            {
+                if(i % 2 == 0)
+                    ind[i] = ind_copy[i / 2];
+                else
+                    ind[i] = ind_copy[dim_m - 1 - i / 2];
+            }
+        }
+
+        ritz_vec.setZero();
+        for(int i = 0; i < dim_m; i++)
+        {
+            ritz_val[i] = evals[ind[i]];
+            ritz_vec.col(i).head(dim_m) = evecs.col(ind[i]);
+        }
+    }
+
+    // Sort the first nev Ritz pairs in decreasing magnitude order
+    // This is used to return the final results
+    void sort_ritzpair()
+    {
+        SortEigenvalue<Scalar, LARGEST_ALGE> sorting(ritz_val.data(), nev);
+        std::vector<int> ind = sorting.index();
+
+        Vector new_ritz_val(ncv);
+        Matrix new_ritz_vec(ncv, nev);
+        BoolArray new_ritz_conv(nev);
+
+        for(int i = 0; i < nev; i++)
+        {
+            new_ritz_val[i] = ritz_val[ind[i]];
+            new_ritz_vec.col(i) = ritz_vec.col(ind[i]);
+            new_ritz_conv[i] = ritz_conv[ind[i]];
+        }
+
+        ritz_val.head(nev) = new_ritz_val.head(nev);
+        ritz_vec.leftCols(nev) = new_ritz_vec;
+        ritz_conv.swap(new_ritz_conv);
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op_    Pointer to the matrix operation object, which should
+    ///               implement the batched matrix-matrix product
+    ///               `perform_op(Scalar *, Scalar *, int)` as in DenseGenMatProd.
+    /// \param nev_   Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-1\f$,
+    ///               where \f$n\f$ is the size of matrix.
+    /// \param ncv_   Size of the projection subspace. This parameter must satisfy
+    ///               \f$nev < ncv \le n\f$, and is advised to take \f$ncv \ge 2\cdot nev\f$.
+    /// \param bsize_ Number of vectors in each block, typically 4~8. Larger
+    ///               blocks give better level-3 throughput but do more
+    ///               operations per restart cycle.
+    ///
+    SymEigsBlockSolver(OpType *op_, int nev_, int ncv_, int bsize_ = 4) :
+        op(op_),
+        dim_n(op->rows()),
+        nev(nev_),
+        ncv(ncv_ > dim_n ? dim_n : ncv_),
+        bsize(bsize_),
+        nmatop(0),
+        niter(0),
+        dim_m(0),
+        last_bsize(0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3))
+    {
+        if(nev_ < 1 || nev_ > dim_n - 1)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
+
+        if(ncv_ <= nev_ || ncv_ > dim_n)
+            throw std::invalid_argument("ncv must satisfy nev < ncv <= n, n is the size of matrix");
+
+        if(bsize_ < 1 || bsize_ > ncv - nev)
+            throw std::invalid_argument("bsize must satisfy 1 <= bsize <= ncv - nev");
+    }
+
+    ///
+    /// Providing the initial residual block for the algorithm.
+    ///
+    /// \param init_resid Pointer to the initial residual vector. It seeds the
+    ///                   first column of the starting block; the remaining
+    ///                   columns are filled with random vectors.
+    ///
+    void init(const Scalar *init_resid)
+    {
+        fac_V.resize(dim_n, ncv);
+        fac_H.resize(ncv, ncv);
+        fac_F.resize(dim_n, bsize);
+        ritz_val.resize(ncv);
+        ritz_vec.resize(ncv, ncv);
+        ritz_conv.resize(nev);
+
+        fac_V.setZero();
+        fac_H.setZero();
+        ritz_val.setZero();
+        ritz_vec.setZero();
+        ritz_conv.setZero();
+
+        nmatop = 0;
+        niter = 0;
+
+        Vector v(dim_n);
+        std::copy(init_resid, init_resid + dim_n, v.data());
+        Scalar vnorm = v.norm();
+        if(vnorm < prec)
+            throw std::invalid_argument("initial residual vector cannot be zero");
+
+        fac_F = Matrix::Random(dim_n, bsize);
+        fac_F.array() -= 0.5;
+        fac_F.col(0) = v;
+        last_bsize = bsize;
+        dim_m = 0;
+    }
+
+    ///
+    /// Providing a random initial residual block.
+    ///
+    /// This overloaded function generates a random starting block
+    /// for the algorithm. Elements in the block follow independent
+    /// Uniform(-0.5, 0.5) distributions.
+    ///
+    void init()
+    {
+        Vector init_resid = Vector::Random(dim_n);
+        init_resid.array() -= 0.5;
+        init(init_resid.data());
+    }
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of restart iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        // Build the initial subspace
+        factorize_from(0, ncv);
+        retrieve_ritzpair();
+        // Restarting
+        int i, nconv = 0, nev_adj;
+        for(i = 0; i < maxit; i++)
+        {
+            nconv = num_converged(tol);
+            if(nconv >= nev)
+                break;
+
+            nev_adj = nev_adjusted(nconv);
+            restart(nev_adj);
+        }
+        // Sorting results
+        sort_ritzpair();
+
+        niter += i + 1;
+
+        return std::min(nev, nconv);
+    }
+
+    ///
+    /// Returning the number of restart iterations used in the computation.
+    ///
+    int num_iterations() { return niter; }
+
+    ///
+    /// Returning the number of matrix operations used in the computation.
+    /// Each column of a batched product counts as one operation.
+    ///
+    int num_operations() { return nmatop; }
+
+    ///
+    /// Returning the converged eigenvalues.
+    ///
+    /// \return A vector containing the eigenvalues.
+    /// Returned vector type will be `Eigen::Vector<Scalar, ...>`, depending on
+    /// the template parameter `Scalar` defined.
+    ///
+    Vector eigenvalues()
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        Vector res(nconv);
+
+        if(!nconv)
+            return res;
+
+        int j = 0;
+        for(int i = 0; i < nev; i++)
+        {
+            if(ritz_conv[i])
+            {
+                res[j] = ritz_val[i];
+                j++;
+            }
+        }
+
+        return res;
+    }
+
+    ///
+    /// Returning the eigenvectors associated with the converged eigenvalues.
+    ///
+    /// \param nvec The number of eigenvectors to return.
+    ///
+    /// \return A matrix containing the eigenvectors.
+    /// Returned matrix type will be `Eigen::Matrix<Scalar, ...>`,
+    /// depending on the template parameter `Scalar` defined.
+    ///
+    Matrix eigenvectors(int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
+        Matrix res(dim_n, nvec);
+
+        if(!nvec)
+            return res;
+
+        Matrix ritz_vec_conv(dim_m, nvec);
+        int j = 0;
+        for(int i = 0; i < nev && j < nvec; i++)
+        {
+            if(ritz_conv[i])
+            {
+                ritz_vec_conv.col(j) = ritz_vec.col(i).head(dim_m);
+                j++;
+            }
+        }
+
+        res.noalias() = fac_V.leftCols(dim_m) * ritz_vec_conv;
+
+        return res;
+    }
+
+    ///
+    /// Returning all converged eigenvectors.
+    ///
+    Matrix eigenvectors()
+    {
+        return eigenvectors(nev);
+    }
+};
+
+
+#endif // SYM_EIGS_BLOCK_SOLVER_H
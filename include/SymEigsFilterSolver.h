@@ -0,0 +1,250 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SYM_EIGS_FILTER_SOLVER_H
+#define SYM_EIGS_FILTER_SOLVER_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <algorithm>  // std::min
+#include <stdexcept>  // std::invalid_argument, std::logic_error
+
+#include "SymEigsSolver.h"
+#include "MatOp/SparseGenMatProd.h"
+#include "MatOp/ChebyshevFilterMatProd.h"
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class computes eigenvalues of a real symmetric matrix inside a
+/// target interval \f$[lo, hi]\f$ using Chebyshev filtered subspace
+/// iteration — without factorizing any matrix. It is the tool of choice
+/// for interior eigenvalues of operators that are too large to factorize,
+/// where SymEigsShiftSolver is out of reach and the plain `LARGEST_MAGN`
+/// rule converges hopelessly slowly.
+///
+/// The computation is layered on SymEigsSolver: the matrix operation
+/// object is wrapped into a ChebyshevFilterMatProd, which maps the
+/// eigenvalues inside the interval close to one and all others close to
+/// zero, so the interior eigenvectors become the dominant eigenvectors of
+/// the filtered operator and are found by the `LARGEST_ALGE` rule. Since
+/// the filter polynomial is intentionally flat on the target interval it
+/// cannot be inverted value by value; the original eigenvalues are
+/// therefore recovered by a Rayleigh-Ritz projection of the converged
+/// subspace onto the unfiltered operator, which also untangles any mixing
+/// between eigenvectors whose filtered values coincide. Only the pairs
+/// whose recovered eigenvalue falls inside the interval are reported.
+///
+/// \tparam Scalar The element type of the matrix.
+///                Currently supported types are `float`, `double` and `long double`.
+/// \tparam OpType The name of the matrix operation class for \f$A\f$
+///                itself, e.g. SparseGenMatProd or DenseGenMatProd.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Eigen/SparseCore>
+/// #include <SymEigsFilterSolver.h>
+/// #include <MatOp/SparseGenMatProd.h>
+/// #include <iostream>
+///
+/// int main()
+/// {
+///     // A large sparse symmetric matrix M, built elsewhere
+///     Eigen::SparseMatrix<double> M = ...;
+///
+///     // Eigenvalues inside [0.5, 1.5], using a degree-60 filter
+///     SparseGenMatProd<double> op(M);
+///     SymEigsFilterSolver< double, SparseGenMatProd<double> >
+///         eigs(&op, 10, 30, 0.5, 1.5, 60);
+///     int nconv = eigs.compute();
+///
+///     Eigen::VectorXd evalues = eigs.eigenvalues();
+///     std::cout << "Eigenvalues found:\n" << evalues << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template < typename Scalar = double,
+           typename OpType = SparseGenMatProd<double> >
+class SymEigsFilterSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+    const int dim_n;     // dimension of the operator
+    const int nev;       // maximum number of eigenvalues requested
+    const Scalar lo;     // target interval
+    const Scalar hi;
+
+    ChebyshevFilterMatProd<Scalar, OpType> filter;  // the filtered operator
+
+    // The underlying symmetric solver, run on the filtered operator
+    SymEigsSolver< Scalar, LARGEST_ALGE, ChebyshevFilterMatProd<Scalar, OpType> > eigs;
+
+    bool bounds_given;   // whether set_spectral_bounds() was called
+    int nconv;           // number of converged pairs inside the interval
+    Vector evals;        // recovered eigenvalues, in increasing order
+    Matrix evecs;        // the associated eigenvectors
+    bool computed;       // whether compute() has been run
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op_     Pointer to the matrix operation object for \f$A\f$,
+    ///                e.g. an instance of SparseGenMatProd. The operator
+    ///                must be symmetric.
+    /// \param nev_    Maximum number of eigenvalues requested. The interval
+    ///                is assumed to contain no more than `nev_` eigenvalues;
+    ///                if it holds more, only a subset is found.
+    /// \param ncv_    Parameter that controls the convergence speed, as in
+    ///                SymEigsSolver. This parameter must satisfy
+    ///                \f$nev < ncv \le n\f$, and is advised to take
+    ///                \f$ncv \ge 2\cdot nev\f$.
+    /// \param lo_     Lower end of the target interval.
+    /// \param hi_     Upper end of the target interval.
+    /// \param degree_ Degree of the Chebyshev filter, as in
+    ///                ChebyshevFilterMatProd. Each iteration of the solver
+    ///                costs `degree_` products with \f$A\f$.
+    ///
+    SymEigsFilterSolver(OpType *op_, int nev_, int ncv_, Scalar lo_, Scalar hi_, int degree_ = 40) :
+        dim_n(op_->rows()),
+        nev(nev_),
+        lo(lo_), hi(hi_),
+        filter(op_, degree_),
+        eigs(&filter, nev_, ncv_),
+        bounds_given(false),
+        nconv(0),
+        computed(false)
+    {
+        if(lo_ >= hi_)
+            throw std::invalid_argument("SymEigsFilterSolver: interval must satisfy lo < hi");
+    }
+
+    ///
+    /// Supplying the bounds of the spectrum of \f$A\f$ directly, e.g. from
+    /// Gershgorin disks. When this function is not called, the bounds are
+    /// estimated with a short Lanczos run at the beginning of compute().
+    ///
+    void set_spectral_bounds(Scalar blo, Scalar bhi)
+    {
+        filter.set_spectral_bounds(blo, bhi);
+        bounds_given = true;
+    }
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol   Precision parameter for the underlying eigen solver,
+    ///              applied to the filtered operator.
+    ///
+    /// \return Number of converged eigenvalues inside the interval.
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        if(!bounds_given)
+            filter.estimate_spectral_bounds();
+        filter.set_interval(lo, hi);
+
+        eigs.init();
+        const int nc = eigs.compute(maxit, tol);
+        if(nc < 1)
+        {
+            nconv = 0;
+            computed = true;
+            return nconv;
+        }
+
+        // Rayleigh-Ritz projection of the converged subspace onto the
+        // unfiltered operator: the filtered eigenvalues all cluster near
+        // one, so the converged vectors may mix inside the subspace, and
+        // a small dense eigen problem separates them again while
+        // recovering the original eigenvalues
+        Matrix X = eigs.eigenvectors(nc);
+        Matrix AX(dim_n, nc);
+        for(int j = 0; j < nc; j++)
+            filter.perform_base_op(&X(0, j), &AX(0, j));
+
+        Matrix S = X.transpose() * AX;
+        S = Scalar(0.5) * (S + S.transpose()).eval();
+        Eigen::SelfAdjointEigenSolver<Matrix> decomp(S);
+
+        // Keep the pairs that landed inside the interval, already in
+        // increasing order of the eigenvalue
+        nconv = 0;
+        evals.resize(nc);
+        Matrix rot(nc, nc);
+        for(int j = 0; j < nc; j++)
+        {
+            const Scalar v = decomp.eigenvalues()[j];
+            if(v >= lo && v <= hi)
+            {
+                evals[nconv] = v;
+                rot.col(nconv) = decomp.eigenvectors().col(j);
+                nconv++;
+            }
+        }
+        evals.conservativeResize(nconv);
+        evecs.noalias() = X * rot.leftCols(nconv);
+
+        computed = true;
+        return nconv;
+    }
+
+    ///
+    /// Returning the converged eigenvalues inside the interval, in
+    /// increasing order.
+    ///
+    Vector eigenvalues()
+    {
+        if(!computed)
+            throw std::logic_error("SymEigsFilterSolver: need to call compute() first");
+
+        return evals;
+    }
+
+    ///
+    /// Returning the eigenvectors associated with the converged
+    /// eigenvalues, as an \f$n\times nconv\f$ orthonormal matrix.
+    ///
+    Matrix eigenvectors()
+    {
+        if(!computed)
+            throw std::logic_error("SymEigsFilterSolver: need to call compute() first");
+
+        return evecs;
+    }
+
+    ///
+    /// Returning the lower spectral bound used by the filter.
+    ///
+    Scalar spectral_lower() { return filter.spectral_lower(); }
+    ///
+    /// Returning the upper spectral bound used by the filter.
+    ///
+    Scalar spectral_upper() { return filter.spectral_upper(); }
+
+    ///
+    /// Returning the number of iterations used by the underlying eigen
+    /// solver.
+    ///
+    int num_iterations() { return eigs.num_iterations(); }
+
+    ///
+    /// Returning the number of filtered operator applications used in the
+    /// computation; each one costs `degree` products with \f$A\f$.
+    ///
+    int num_operations() { return eigs.num_operations(); }
+};
+
+
+#endif // SYM_EIGS_FILTER_SOLVER_H
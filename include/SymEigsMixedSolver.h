@@ -0,0 +1,166 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SYM_EIGS_MIXED_SOLVER_H
+#define SYM_EIGS_MIXED_SOLVER_H
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SymEigsSolver.h"
+#include "MatOp/DenseGenMatProd.h"
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a mixed-precision eigen solver for real symmetric
+/// matrices. The solve is split into two phases. The first phase runs the
+/// Lanczos iterations, which dominate both the memory footprint (the \f$V\f$
+/// basis) and the memory traffic (matrix-vector products and
+/// reorthogonalization), entirely in single precision, down to the accuracy
+/// that single precision can resolve. The second phase refines the result to
+/// the requested tolerance with a double precision SymEigsSolver that is
+/// warm-started from the single precision invariant subspace: its initial
+/// residual vector is the combination of the converged single precision Ritz
+/// vectors, so it is already almost free of components outside the wanted
+/// subspace and the double solve needs far fewer iterations than a cold
+/// start. The final accuracy is therefore identical to a pure double
+/// precision solve, while a large share of the matrix operations move only
+/// half the bytes.
+///
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the requested eigenvalues, for example `LARGEST_MAGN`
+///                       to retrieve eigenvalues with the largest magnitude.
+/// \tparam OpTypeF       The type of the single precision operation object,
+///                       used in the first phase.
+/// \tparam OpTypeD       The type of the double precision operation object,
+///                       used in the refinement phase.
+///
+template < int SelectionRule = LARGEST_MAGN,
+           typename OpTypeF = DenseGenMatProd<float>,
+           typename OpTypeD = DenseGenMatProd<double> >
+class SymEigsMixedSolver
+{
+private:
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Matrix<float, Eigen::Dynamic, 1> VectorF;
+
+    const int dim_n;        // dimension of matrix A
+
+    SymEigsSolver<float, SelectionRule, OpTypeF> solver_f;
+    SymEigsSolver<double, SelectionRule, OpTypeD> solver_d;
+
+public:
+    ///
+    /// Constructor to create a mixed-precision solver object.
+    ///
+    /// \param op_f_ Pointer to the single precision matrix operation object,
+    ///              typically built from a `float` copy of the matrix.
+    /// \param op_d_ Pointer to the double precision matrix operation object.
+    ///              Both objects must represent the same matrix.
+    /// \param nev_  Number of eigenvalues requested.
+    /// \param ncv_  Parameter that controls the convergence speed of the
+    ///              algorithm, see SymEigsSolver for details.
+    ///
+    SymEigsMixedSolver(OpTypeF *op_f_, OpTypeD *op_d_, int nev_, int ncv_) :
+        dim_n(op_d_->rows()),
+        solver_f(op_f_, nev_, ncv_),
+        solver_d(op_d_, nev_, ncv_)
+    {}
+
+    ///
+    /// Providing the initial residual vector for the algorithm.
+    ///
+    /// \param init_resid Pointer to the initial residual vector, in
+    ///                   single precision.
+    ///
+    void init(const float *init_resid) { solver_f.init(init_resid); }
+
+    ///
+    /// Providing a random initial residual vector, see SymEigsSolver::init().
+    ///
+    void init() { solver_f.init(); }
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of iterations allowed in each of the
+    ///              two phases.
+    /// \param tol   Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute(int maxit = 1000, double tol = 1e-10)
+    {
+        // The single precision phase cannot resolve residuals below the
+        // single precision limit, so cap the tolerance passed to it
+        const float fprec = std::pow(std::numeric_limits<float>::epsilon(), 2.0f / 3);
+        const float ftol = std::max(static_cast<float>(tol), fprec);
+        int nconv_f = solver_f.compute(maxit, ftol);
+
+        if(nconv_f < 1)
+        {
+            // Single precision phase failed to converge anything useful,
+            // fall back to an ordinary double precision solve
+            solver_d.init();
+            return solver_d.compute(maxit, tol);
+        }
+
+        // Combine the converged Ritz vectors into the initial residual of
+        // the double precision solve. The combination spans no direction
+        // outside the (approximate) invariant subspace, so the double
+        // precision Lanczos iterations start essentially converged and
+        // only need to remove the single precision error
+        Vector v0 = solver_f.eigenvectors(nconv_f).template cast<double>().rowwise().sum();
+        solver_d.init(v0.data());
+        return solver_d.compute(maxit, tol);
+    }
+
+    ///
+    /// Returning the total number of restarting iterations, summed over
+    /// the two phases.
+    ///
+    int num_iterations() { return solver_f.num_iterations() + solver_d.num_iterations(); }
+
+    ///
+    /// Returning the number of matrix operations performed in single
+    /// precision.
+    ///
+    int num_operations_single() { return solver_f.num_operations(); }
+
+    ///
+    /// Returning the number of matrix operations performed in double
+    /// precision.
+    ///
+    int num_operations_double() { return solver_d.num_operations(); }
+
+    ///
+    /// Returning the total number of matrix operations, summed over the
+    /// two phases.
+    ///
+    int num_operations() { return solver_f.num_operations() + solver_d.num_operations(); }
+
+    ///
+    /// Returning the eigenvalues, in double precision.
+    ///
+    /// \return A vector containing the eigenvalues.
+    ///
+    Vector eigenvalues() { return solver_d.eigenvalues(); }
+
+    ///
+    /// Returning the eigenvectors, in double precision.
+    ///
+    /// \return A matrix containing the eigenvectors, with each column being
+    ///         an eigenvector.
+    ///
+    Matrix eigenvectors() { return solver_d.eigenvectors(); }
+};
+
+
+#endif // SYM_EIGS_MIXED_SOLVER_H
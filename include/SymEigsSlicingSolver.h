@@ -0,0 +1,337 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SYM_EIGS_SLICING_SOLVER_H
+#define SYM_EIGS_SLICING_SOLVER_H
+
+#include <Eigen/Core>
+#include <vector>     // std::vector
+#include <cmath>      // std::abs
+#include <algorithm>  // std::sort, std::copy, std::min, std::max
+#include <limits>     // std::numeric_limits
+#include <utility>    // std::pair
+#include <stdexcept>  // std::invalid_argument
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "SymEigsSolver.h"
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements a spectrum-slicing driver for real symmetric
+/// matrices. It computes the eigenvalues of \f$A\f$ lying in a window by
+/// running one shift-and-invert solve per shift value \f$\sigma_i\f$ of a
+/// given ladder, and then merging the per-shift results into a single
+/// deduplicated list. The individual solves are independent, so they are
+/// executed concurrently when OpenMP is available; without OpenMP they run
+/// serially and produce the same results.
+///
+/// Since each shift-solve operation object carries its own factorization
+/// state, which is modified by set_shift(), one operation object per slice
+/// must be supplied. For the built-in wrapper classes such as
+/// DenseSymShiftSolve this is cheap, as they only reference the matrix
+/// data instead of copying it.
+///
+/// \tparam Scalar The element type of the matrix.
+///                Currently supported types are `float`, `double` and `long double`.
+/// \tparam OpType The name of the matrix operation class, with the same
+///                requirements as in SymEigsShiftSolver.
+///
+/// Below is an example that computes all eigenvalues of a matrix in the
+/// interval \f$[0, 5]\f$ using four slices:
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <SymEigsSlicingSolver.h>
+/// #include <iostream>
+///
+/// int main()
+/// {
+///     Eigen::MatrixXd A = Eigen::MatrixXd::Random(100, 100);
+///     Eigen::MatrixXd M = A + A.transpose();
+///
+///     // One shift-solve object per slice, all referencing the same matrix
+///     const int nslice = 4;
+///     std::vector< DenseSymShiftSolve<double> > ops(nslice, DenseSymShiftSolve<double>(M));
+///     std::vector< DenseSymShiftSolve<double>* > op_ptr(nslice);
+///     for(int i = 0; i < nslice; i++)
+///         op_ptr[i] = &ops[i];
+///
+///     SymEigsSlicingSolver< double, DenseSymShiftSolve<double> >
+///         eigs(&op_ptr[0], nslice, 0.0, 5.0, 8, 20);
+///     int nfound = eigs.compute();
+///
+///     std::cout << "Eigenvalues in [0, 5]:\n" << eigs.eigenvalues() << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template < typename Scalar = double,
+           typename OpType = DenseSymShiftSolve<double> >
+class SymEigsSlicingSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Map<Matrix> MapMat;
+
+    // An eigenvalue found by a slice, together with the slice index and
+    // the column of the slice's eigenvector matrix it came from. Sorting
+    // by the value groups duplicates found by adjacent slices together.
+    typedef std::pair<Scalar, std::pair<int, int> > Candidate;
+
+    OpType **ops;        // one shift-solve object per slice
+    const int nslice;    // number of slices
+    const int dim_n;     // dimension of matrix A
+    const int nev;       // number of eigenvalues requested per slice
+    const int ncv;       // ncv parameter of the per-slice solvers
+    int nthread;         // number of threads to use
+
+    Vector sigma;        // the ladder of shifts
+    bool use_window;     // whether results are restricted to a window
+    Scalar lower;        // lower end of the window
+    Scalar upper;        // upper end of the window
+
+    const Scalar prec;   // precision parameter, see SymEigsSolver
+
+    Vector merged_val;   // deduplicated eigenvalues, in increasing order
+    Matrix merged_vec;   // the associated eigenvectors
+
+    void check_args(int nslice_, int nev_, int ncv_)
+    {
+        if(nslice_ < 1)
+            throw std::invalid_argument("nslice must be at least one");
+        if(ops == NULL)
+            throw std::invalid_argument("operation object array cannot be NULL");
+        for(int i = 0; i < nslice_; i++)
+        {
+            if(ops[i] == NULL)
+                throw std::invalid_argument("operation objects cannot be NULL");
+            if(ops[i]->rows() != dim_n)
+                throw std::invalid_argument("operation objects must have the same dimension");
+        }
+        // nev and ncv themselves are validated by the per-slice solvers
+    }
+
+public:
+    ///
+    /// Constructor taking an explicit ladder of shifts. Around each shift
+    /// \f$\sigma_i\f$, the `nev` eigenvalues closest to it are computed,
+    /// and eigenvalues found by more than one slice are reported once.
+    ///
+    /// \param ops_     Pointer to an array of `nslice_` operation object
+    ///                 pointers. Each object should implement the
+    ///                 shift-solve operation as in SymEigsShiftSolver, and
+    ///                 they must not be shared between slices, since
+    ///                 set_shift() modifies their internal state.
+    /// \param nslice_  Number of slices, i.e. the length of the ladder.
+    /// \param sigma_   Pointer to the `nslice_` shift values.
+    /// \param nev_     Number of eigenvalues requested per slice.
+    /// \param ncv_     The ncv parameter of the per-slice solvers, see
+    ///                 SymEigsShiftSolver.
+    /// \param nthread_ Number of threads to use. The default value zero
+    ///                 means using all the threads the OpenMP runtime
+    ///                 provides.
+    ///
+    SymEigsSlicingSolver(OpType **ops_, int nslice_, const Scalar *sigma_,
+                         int nev_, int ncv_, int nthread_ = 0) :
+        ops(ops_), nslice(nslice_),
+        dim_n(ops_ == NULL || ops_[0] == NULL ? 0 : ops_[0]->rows()),
+        nev(nev_), ncv(ncv_), nthread(nthread_),
+        use_window(false), lower(0), upper(0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3))
+    {
+        check_args(nslice_, nev_, ncv_);
+        sigma.resize(nslice);
+        std::copy(sigma_, sigma_ + nslice, sigma.data());
+
+#ifdef _OPENMP
+        if(nthread < 1)
+            nthread = omp_get_max_threads();
+#else
+        if(nthread < 1)
+            nthread = 1;
+#endif
+    }
+
+    ///
+    /// Constructor taking an interval and a slice count. The shifts are
+    /// placed at the midpoints of `nslice_` equal sub-intervals of
+    /// \f$[lower, upper]\f$, and only eigenvalues inside the interval are
+    /// reported. The per-slice `nev_` should be chosen so that adjacent
+    /// slices overlap, i.e. each slice reaches past the midpoints of its
+    /// neighbours; otherwise eigenvalues between two shifts may be missed.
+    ///
+    /// \param ops_     Pointer to an array of `nslice_` operation object
+    ///                 pointers, see above.
+    /// \param nslice_  Number of slices the interval is divided into.
+    /// \param lower_   Lower end of the interval.
+    /// \param upper_   Upper end of the interval.
+    /// \param nev_     Number of eigenvalues requested per slice.
+    /// \param ncv_     The ncv parameter of the per-slice solvers.
+    /// \param nthread_ Number of threads to use, zero meaning all.
+    ///
+    SymEigsSlicingSolver(OpType **ops_, int nslice_, Scalar lower_, Scalar upper_,
+                         int nev_, int ncv_, int nthread_ = 0) :
+        ops(ops_), nslice(nslice_),
+        dim_n(ops_ == NULL || ops_[0] == NULL ? 0 : ops_[0]->rows()),
+        nev(nev_), ncv(ncv_), nthread(nthread_),
+        use_window(true), lower(lower_), upper(upper_),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3))
+    {
+        check_args(nslice_, nev_, ncv_);
+        if(upper_ <= lower_)
+            throw std::invalid_argument("the interval [lower, upper] is empty");
+
+        sigma.resize(nslice);
+        const Scalar width = (upper - lower) / Scalar(nslice);
+        for(int i = 0; i < nslice; i++)
+            sigma[i] = lower + (Scalar(i) + Scalar(0.5)) * width;
+    }
+
+    ///
+    /// Conducting the per-slice solves and merging the results.
+    ///
+    /// \param maxit Maximum number of iterations allowed for each slice.
+    /// \param tol Precision parameter of the per-slice solvers.
+    ///
+    /// \return Number of distinct converged eigenvalues found, i.e. the
+    ///         length of the vector returned by eigenvalues().
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        std::vector<Vector> slice_val(nslice);
+        std::vector<Matrix> slice_vec(nslice);
+
+        // The slices are independent and each one works on its own
+        // operation object and solver state, so they can run concurrently.
+        // Exceptions must not leave the parallel region; a slice that
+        // fails simply contributes no eigenvalues to the merge below.
+        const int nt = std::min(nthread, nslice);
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic) num_threads(nt)
+#endif
+        for(int i = 0; i < nslice; i++)
+        {
+            try {
+                SymEigsShiftSolver<Scalar, LARGEST_MAGN, OpType>
+                    eigs(ops[i], nev, ncv, sigma[i]);
+                eigs.init();
+                int nconv = eigs.compute(maxit, tol);
+                if(nconv > 0)
+                {
+                    slice_val[i] = eigs.eigenvalues();
+                    slice_vec[i] = eigs.eigenvectors();
+                }
+            } catch(std::exception &) {}
+        }
+        (void)nt;
+
+        // Collect the candidates, restricted to the window if one was given
+        std::vector<Candidate> cand;
+        cand.reserve(nslice * nev);
+        for(int i = 0; i < nslice; i++)
+        {
+            for(int j = 0; j < slice_val[i].size(); j++)
+            {
+                const Scalar val = slice_val[i][j];
+                if(use_window && (val < lower || val > upper))
+                    continue;
+                cand.push_back(Candidate(val, std::make_pair(i, j)));
+            }
+        }
+        std::sort(cand.begin(), cand.end());
+
+        // Walk the sorted candidates and group values that agree within
+        // the merging tolerance; such groups are the same eigenvalue found
+        // by adjacent slices. Each group is represented by the copy whose
+        // shift is closest to the value, which is the best converged one.
+        const Scalar mtol = std::max(prec, Scalar(10) * tol);
+        std::vector<int> keep;
+        const int ncand = cand.size();
+        int g = 0;
+        while(g < ncand)
+        {
+            int best = g;
+            int h = g + 1;
+            while(h < ncand &&
+                  cand[h].first - cand[g].first <=
+                      mtol * std::max(Scalar(1), std::abs(cand[g].first)))
+            {
+                if(std::abs(cand[h].first - sigma[cand[h].second.first]) <
+                   std::abs(cand[best].first - sigma[cand[best].second.first]))
+                    best = h;
+                h++;
+            }
+            keep.push_back(best);
+            g = h;
+        }
+
+        // Assemble the merged results, in increasing order of the values
+        const int nfound = keep.size();
+        merged_val.resize(nfound);
+        merged_vec.resize(dim_n, nfound);
+        for(int i = 0; i < nfound; i++)
+        {
+            const Candidate &c = cand[keep[i]];
+            merged_val[i] = c.first;
+            merged_vec.col(i) = slice_vec[c.second.first].col(c.second.second);
+        }
+
+        return nfound;
+    }
+
+    ///
+    /// Returning the number of distinct converged eigenvalues found by the
+    /// last call to compute().
+    ///
+    int num_converged_eigenvalues() { return merged_val.size(); }
+
+    ///
+    /// Returning the merged eigenvalues, in increasing order.
+    ///
+    /// \return A vector containing the eigenvalues.
+    ///
+    Vector eigenvalues() { return merged_val; }
+
+    ///
+    /// Writing the merged eigenvalues directly into a caller-supplied
+    /// buffer, avoiding the allocation of the returned vector.
+    ///
+    /// \param dest Pointer to a buffer of at least num_converged_eigenvalues()
+    ///             scalars.
+    ///
+    void eigenvalues(Scalar *dest)
+    {
+        std::copy(merged_val.data(), merged_val.data() + merged_val.size(), dest);
+    }
+
+    ///
+    /// Returning the eigenvectors associated with the merged eigenvalues,
+    /// in the same order as eigenvalues().
+    ///
+    /// \return A matrix containing the eigenvectors as its columns.
+    ///
+    Matrix eigenvectors() { return merged_vec; }
+
+    ///
+    /// Writing the merged eigenvectors directly into a caller-supplied
+    /// buffer of at least \f$n\times\f$ num_converged_eigenvalues()
+    /// scalars, in column-major order.
+    ///
+    void eigenvectors(Scalar *dest)
+    {
+        MapMat res(dest, dim_n, merged_vec.cols());
+        res.noalias() = merged_vec;
+    }
+};
+
+
+#endif // SYM_EIGS_SLICING_SOLVER_H
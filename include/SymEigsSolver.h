@@ -13,9 +13,12 @@
 #include <cmath>      // std::abs, std::pow
 #include <algorithm>  // std::min, std::copy
 #include <limits>     // std::numeric_limits
+#include <new>        // placement new for re-mapping fac_V
 #include <stdexcept>  // std::invalid_argument
 
 #include "SelectionRule.h"
+#include "ReorthRule.h"
+#include "SolverStats.h"
 #include "UpperHessenbergQR.h"
 #include "TridiagEigen.h"
 #include "MatOp/DenseGenMatProd.h"
@@ -66,6 +69,19 @@
 ///                       use the DenseGenMatProd wrapper class, or define their
 ///                       own that impelemnts all the public member functions as in
 ///                       DenseGenMatProd.
+/// \tparam StatsPolicy   The statistics policy class. The default NullSolverStats
+///                       compiles all instrumentation out; passing SolverStats
+///                       instead makes the solver record per-phase wall time and
+///                       event counts, accessible through the stats() member.
+/// \tparam MaxNcv        Optional compile-time upper bound on `ncv`. When a
+///                       deployment uses a small constant subspace size, passing
+///                       it here turns the internal storage of the dense
+///                       \f$ncv\times ncv\f$ subproblems (TridiagQR and
+///                       TridiagEigen) into fixed-capacity objects: the
+///                       per-restart temporaries live inline instead of on the
+///                       heap, which is worthwhile in streaming workloads that
+///                       solve many small problems. The default `Eigen::Dynamic`
+///                       keeps the dynamic-size behavior.
 ///
 /// Below is an example that demonstrates the usage of this class.
 ///
@@ -140,7 +156,9 @@
 ///
 template < typename Scalar = double,
            int SelectionRule = LARGEST_MAGN,
-           typename OpType = DenseGenMatProd<double> >
+           typename OpType = DenseGenMatProd<double>,
+           typename StatsPolicy = NullSolverStats<Scalar>,
+           int MaxNcv = Eigen::Dynamic >
 class SymEigsSolver
 {
 private:
@@ -152,6 +170,11 @@ private:
     typedef Eigen::Map<Vector> MapVec;
     typedef Eigen::SelfAdjointEigenSolver<Matrix> EigenSolver;
 
+    // The storage types of the ncv-sized decomposition results; identical
+    // to the dynamic types when MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxNcv, MaxNcv> SmallMatrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> SmallVector;
+
 protected:
     OpType *op;          // object to conduct matrix operation,
                          // e.g. matrix-vector product
@@ -163,11 +186,25 @@ protected:
     const int nev;       // number of eigenvalues requested
 
 private:
-    const int ncv;       // number of ritz values
+    int ncv;             // number of ritz values; changes between the
+                         // restarts when adaptive tuning is enabled
+    int ncv_min;         // lower bound of ncv for the adaptive tuning
+    int ncv_max;         // upper bound of ncv; zero disables the tuning
+    int adapt_window;    // number of restarts observed before adapting
+    int ncv_next;        // subspace size to switch to at the next restart
+    int adapt_last;      // nconv observed at the previous restart
+    int adapt_stall;     // consecutive restarts without a new converged pair
+    int adapt_fast;      // consecutive restarts each converging a new pair
     int nmatop;          // number of matrix operations called
     int niter;           // number of restarting iterations
-
-    Matrix fac_V;        // V matrix in the Arnoldi factorization
+    int nlocked;         // number of converged Ritz pairs locked in the
+                         // leading columns of the factorization
+
+    Matrix fac_V_data;   // in-RAM storage of the V matrix, used when no
+                         // external basis buffer is provided
+    Scalar *basis_ptr;   // external buffer holding the V matrix, e.g. a
+                         // memory-mapped file (NULL for in-RAM storage)
+    MapMat fac_V;        // V matrix in the Arnoldi factorization
     Matrix fac_H;        // H matrix in the Arnoldi factorization
     Vector fac_f;        // residual in the Arnoldi factorization
 
@@ -176,6 +213,9 @@ protected:
 
 private:
     Matrix ritz_vec;     // ritz vectors
+    Vector ritz_est;     // last row of the eigenvector matrix of fac_H,
+                         // used to estimate residuals during the restart
+                         // iterations without computing full Ritz vectors
     BoolArray ritz_conv; // indicator of the convergence of ritz values
 
     const Scalar prec;   // precision parameter used to test convergence
@@ -183,6 +223,77 @@ private:
                          // epsilon is the machine precision,
                          // e.g. ~= 1e-16 for the "double" type
 
+    int reorth_rule;     // reorthogonalization strategy, one of the
+                         // REORTH_* enumeration values
+
+    int stop_minconv;    // early-exit threshold of the stopping rule;
+                         // 0 means iterate until all nev have converged
+    double stop_maxtime; // wall-clock budget in seconds; 0 means unlimited
+    Vector stop_tol;     // per-Ritz-position tolerances; an empty vector
+                         // means the uniform tol argument of compute()
+    // Per-restart callback and its opaque user data; returning false
+    // from the callback aborts the iterations
+    bool (*stop_callback)(int iter, int nconv, const Scalar *ritz_val,
+                          const Scalar *resid_est, int nvals, void *data);
+    void *stop_callback_data;
+
+    // Reduction hook of the distributed mode and its opaque user data;
+    // it performs an in-place all-reduce (sum) of a small buffer across
+    // all ranks, and is NULL in the default single-process mode
+    void (*reduce_hook)(Scalar *buf, int len, void *data);
+    void *reduce_hook_data;
+
+    // Preallocated workspace, sized once in init(), so that the hot-path
+    // routines below do not touch the heap during the iterations
+    Vector ws_w;               // length-n scratch to receive perform_op() results
+    Vector ws_Vf;              // coefficients in the reorthogonalization step
+    Vector ws_fk;              // new residual vector computed in restart()
+    Vector ws_resid;           // residual estimates passed to the callback
+    Matrix ws_Q;               // accumulated rotation matrix in restart()
+    Matrix ws_Vs;              // new basis columns computed in restart()
+    TridiagQR<Scalar, MaxNcv> ws_decomp;     // QR decomposition reused for
+                                             // all shifts
+    TridiagEigen<Scalar, MaxNcv> ws_eig;  // eigen decomposition of fac_H, reused
+                                  // across the restarts
+    SortEigenvalue<Scalar, SelectionRule> ws_sort;  // sorting machinery,
+                                                    // reused across the restarts
+    std::vector<int> ws_ind;      // order index of the Ritz values
+    std::vector<int> ws_ind2;     // scratch for the BOTH_ENDS reordering
+
+    StatsPolicy stats_rec;     // per-phase statistics, a no-op recorder
+                               // by default
+
+    // All-reduce a small buffer across the ranks, a no-op without a hook.
+    // Every inner product and norm of a length-n vector goes through
+    // here, so in distributed mode each rank works on its own row slice
+    // while all ranks agree bit-for-bit on the reduced scalars, and the
+    // replicated ncv-sized quantities (fac_H, the QR sweeps and the
+    // tridiagonal eigen decomposition) stay coherent without any
+    // further communication
+    void global_reduce(Scalar *buf, int len)
+    {
+        if(reduce_hook != NULL)
+            reduce_hook(buf, len, reduce_hook_data);
+    }
+
+    // Globally-reduced inner product of two distributed length-n vectors
+    template <typename DerivedA, typename DerivedB>
+    Scalar global_dot(const Eigen::MatrixBase<DerivedA> &a, const Eigen::MatrixBase<DerivedB> &b)
+    {
+        Scalar res = a.dot(b);
+        global_reduce(&res, 1);
+        return res;
+    }
+
+    // Globally-reduced norm of a distributed length-n vector
+    template <typename Derived>
+    Scalar global_norm(const Eigen::MatrixBase<Derived> &v)
+    {
+        Scalar res = v.squaredNorm();
+        global_reduce(&res, 1);
+        return std::sqrt(res);
+    }
+
     // Arnoldi factorization starting from step-k
     void factorize_from(int from_k, int to_m, const Vector &fk)
     {
@@ -190,39 +301,92 @@ private:
 
         fac_f = fk;
 
-        Vector w(dim_n);
         Scalar beta = 0.0, Hii = 0.0;
         // Keep the upperleft k x k submatrix of H and set other elements to 0
         fac_H.rightCols(ncv - from_k).setZero();
         fac_H.block(from_k, 0, ncv - from_k, from_k).setZero();
         for(int i = from_k; i <= to_m - 1; i++)
         {
-            beta = fac_f.norm();
+            beta = global_norm(fac_f);
             MapVec v(&fac_V(0, i), dim_n); // The (i+1)-th column
             v.noalias() = fac_f / beta;
             fac_H(i, i - 1) = beta;
 
-            op->perform_op(v.data(), w.data());
+            // For the default NullSolverStats policy, wall_time() is an
+            // inline constant and the add_*() calls are empty, so the
+            // timing code below disappears at compile time
+            double t_op = StatsPolicy::wall_time();
+            op->perform_op(v.data(), ws_w.data());
             nmatop++;
+            stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
 
-            Hii = v.dot(w);
+            Hii = global_dot(v, ws_w);
             fac_H(i - 1, i) = beta;
             fac_H(i, i) = Hii;
 
-            fac_f.noalias() = w - beta * fac_V.col(i - 1) - Hii * v;
+            fac_f.noalias() = ws_w - beta * fac_V.col(i - 1) - Hii * v;
+            reorthogonalize(i + 1);
+        }
+    }
+
+    // One classical Gram-Schmidt correction pass of fac_f against the
+    // first ncols basis columns. Both the projection and the update are
+    // GEMV passes over a contiguous column panel of fac_V, which go
+    // through the blocked level-2 kernels
+    void reorth_pass(int ncols)
+    {
+        ws_Vf.head(ncols).noalias() = fac_V.leftCols(ncols).transpose() * fac_f;
+        global_reduce(ws_Vf.data(), ncols);
+        fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+    }
+
+    // Orthogonality maintenance of fac_f against the first ncols basis
+    // columns, following the strategy selected by reorth_rule
+    void reorthogonalize(int ncols)
+    {
+        if(reorth_rule == REORTH_NONE)
+            return;
+
+        double t_re = StatsPolicy::wall_time();
+        if(reorth_rule == REORTH_FULL)
+        {
+            stats_rec.reorth_hit();
+            reorth_pass(ncols);
+        }
+        else if(reorth_rule == REORTH_DGKS)
+        {
+            // Iterated CGS with the eta test of Daniel, Gragg, Kaufman
+            // and Stewart: a correction pass is needed whenever the new
+            // residual is much shorter than the vector it was computed
+            // from, and is repeated while that keeps being the case
+            const Scalar eta = Scalar(1) / std::sqrt(Scalar(2));
+            Scalar last = global_norm(ws_w);
+            Scalar fnorm = global_norm(fac_f);
+            for(int pass = 0; pass < 3 && fnorm < eta * last; pass++)
+            {
+                stats_rec.reorth_hit();
+                reorth_pass(ncols);
+                last = fnorm;
+                fnorm = global_norm(fac_f);
+            }
+        }
+        else  // REORTH_STANDARD
+        {
             // Correct f if it is not orthogonal to V
             // Typically the largest absolute value occurs in
             // the first element, i.e., <v1, f>, so we use this
             // to test the orthogonality
-            Scalar v1f = fac_f.dot(fac_V.col(0));
+            Scalar v1f = global_dot(fac_f, fac_V.col(0));
             if(v1f > prec || v1f < -prec)
             {
-                Vector Vf(i + 1);
-                Vf.tail(i) = fac_V.block(0, 1, dim_n, i).transpose() * fac_f;
-                Vf[0] = v1f;
-                fac_f -= fac_V.leftCols(i + 1) * Vf;
+                ws_Vf.segment(1, ncols - 1).noalias() = fac_V.block(0, 1, dim_n, ncols - 1).transpose() * fac_f;
+                global_reduce(&ws_Vf[1], ncols - 1);
+                ws_Vf[0] = v1f;
+                fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+                stats_rec.reorth_hit();
             }
         }
+        stats_rec.add_reorth_time(StatsPolicy::wall_time() - t_re);
     }
 
     // Implicitly restarted Arnoldi factorization
@@ -230,50 +394,197 @@ private:
     {
         if(k >= ncv)
             return;
+        // The locked leading columns are frozen, so the QR sweeps and the
+        // basis update below only operate on the active trailing block
+        if(k <= nlocked)
+            k = nlocked + 1;
+
+        const int nl = nlocked;
+        const int na = ncv - nl;   // size of the active block
+        const int kk = k - nl;     // number of active columns kept
+
+        Eigen::Ref<Matrix> Ha = fac_H.block(nl, nl, na, na);
+        Eigen::Ref<Matrix> Qa = ws_Q.topLeftCorner(na, na);
+        Qa.setIdentity();
+
+        double t_rs = StatsPolicy::wall_time();
+
+        // All the unwanted Ritz values are applied as shifts in one fused
+        // sweep: H -> Q'HQ with QR = H - mu * I for each shift mu, and the
+        // rotations of every shift are replayed on the accumulator in a
+        // single cache-blocked pass
+        ws_decomp.sweep_shifts(Ha, ritz_val.segment(k, ncv - k), Qa);
+        // V -> VQ, only need to update the first kk+1 active columns
+        // Q has some zero elements in its lower-left corner, but exploiting
+        // them column by column would turn this update into a sequence of
+        // matrix-vector products; a single matrix-matrix product wastes a
+        // fraction of the flops on those zeros and still runs much faster,
+        // since it goes through the blocked level-3 kernels
+        ws_Vs.leftCols(kk + 1).noalias() = fac_V.middleCols(nl, na) * Qa.leftCols(kk + 1);
+        fac_V.middleCols(nl, kk + 1).noalias() = ws_Vs.leftCols(kk + 1);
+
+        stats_rec.restart_hit();
+        stats_rec.add_restart_time(StatsPolicy::wall_time() - t_rs);
+
+        ws_fk.noalias() = fac_f * ws_Q(na - 1, kk - 1) + fac_V.col(k) * fac_H(k, k - 1);
+        // The factorization has just been compressed to k columns, which
+        // is the only point where the subspace size can change cheaply
+        if(ncv_next != ncv)
+            resize_subspace(std::max(ncv_next, k + 2));
+        factorize_from(k, ncv, ws_fk);
+        // Full Ritz vectors are not needed inside the iterations
+        retrieve_ritzpair(false);
+    }
+
+    // Deflate converged "wanted" Ritz pairs into a locked leading block of
+    // the factorization. Locked columns of fac_V hold converged Ritz
+    // vectors, the corresponding part of fac_H becomes diagonal with zero
+    // coupling, and later calls to restart() skip them entirely. The
+    // residual components on the locked pairs are below the convergence
+    // threshold and are dropped, which is the usual locking approximation.
+    void lock_converged(Scalar tol)
+    {
+        const int nl = nlocked;
+        const int na = ncv - nl;
+        const int nwant = nev - nl;
+        if(nwant <= 0 || na <= 2)
+            return;
+
+        // Eigen decomposition of the active block of H, through the same
+        // preallocated machinery as retrieve_ritzpair() so that no memory
+        // is allocated before the bail-out below
+        Eigen::Ref<Matrix> Ha = fac_H.block(nl, nl, na, na);
+        ws_eig.compute(Ha);
+        const SmallVector &evals = ws_eig.eigenvalues();
+        const SmallMatrix &evecs = ws_eig.eigenvectors();
+
+        ws_sort.compute(evals.data(), na);
+        int *ind = &ws_ind[0];
+        // Same reordering as in retrieve_ritzpair(), so that the first
+        // values in `ind` are always the wanted collection
+        if(SelectionRule == BOTH_ENDS)
+        {
+            ws_sort.index(&ws_ind2[0]);
+            for(int i = 0; i < na; i++)
+            {
+                if(i % 2 == 0)
+                    ind[i] = ws_ind2[i / 2];
+                else
+                    ind[i] = ws_ind2[na - 1 - i / 2];
+            }
+        } else {
+            ws_sort.index(ind);
+        }
 
-        TridiagQR<Scalar> decomp;
-        Matrix Q = Matrix::Identity(ncv, ncv);
+        // Split the active pairs into converged wanted ones (to be locked)
+        // and the rest, using the same criterion as num_converged()
+        const Scalar f_norm = global_norm(fac_f);
+        std::vector<int> lock_ind, rest_ind;
+        for(int j = 0; j < na; j++)
+        {
+            const int i = ind[j];
+            const Scalar thresh = tol * std::max(prec, std::abs(evals[i]));
+            const Scalar resid = std::abs(evecs(na - 1, i)) * f_norm;
+            // Keep at least two active columns so that the iterations
+            // can continue
+            if(j < nwant && resid < thresh && na - (int)lock_ind.size() > 2)
+                lock_ind.push_back(i);
+            else
+                rest_ind.push_back(i);
+        }
+        const int nnew = lock_ind.size();
+        if(nnew < 1)
+            return;
+        const int nr = na - nnew;
 
-        for(int i = k; i < ncv; i++)
+        // Components of the residual on the non-locked Ritz vectors
+        Vector theta(nr), c(nr);
+        for(int j = 0; j < nr; j++)
         {
-            // QR decomposition of H-mu*I, mu is the shift
-            fac_H.diagonal().array() -= ritz_val[i];
-            decomp.compute(fac_H);
-
-            // Q -> Q * Qi
-            decomp.apply_YQ(Q);
-            // H -> Q'HQ
-            // Since QR = H - mu * I, we have H = QR + mu * I
-            // and therefore Q'HQ = RQ + mu * I
-            fac_H = decomp.matrix_RQ();
-            fac_H.diagonal().array() += ritz_val[i];
+            theta[j] = evals[rest_ind[j]];
+            c[j] = evecs(na - 1, rest_ind[j]);
         }
-        // V -> VQ, only need to update the first k+1 columns
-        // Q has some elements being zero
-        // The first (ncv - k + i) elements of the i-th column of Q are non-zero
-        Matrix Vs(dim_n, k + 1);
-        int nnz;
-        for(int i = 0; i < k; i++)
+        const Scalar cnorm = c.norm();
+        if(cnorm < prec)
+            return;
+
+        // The non-locked part must be brought back to Lanczos form: we
+        // need an orthogonal G such that G' * diag(theta) * G is
+        // tridiagonal and G' * c lands on a single coordinate. Running a
+        // small Lanczos recurrence on diag(theta) started from c / ||c||
+        // produces exactly this, with the coupling on the first
+        // coordinate; reversing the column order of G then moves it to
+        // the last one, as the factorization requires.
+        // Everything here is of size ncv at most, and locking happens at
+        // most nev times per solve, so this is far from the hot path.
+        Matrix G(nr, nr);
+        G.col(0) = c / cnorm;
+        for(int j = 0; j < nr - 1; j++)
         {
-            nnz = ncv - k + i + 1;
-            MapMat V(fac_V.data(), dim_n, nnz);
-            MapVec q(&Q(0, i), nnz);
-            Vs.col(i).noalias() = V * q;
+            Vector w = theta.asDiagonal() * G.col(j);
+            // Full reorthogonalization, twice
+            for(int rep = 0; rep < 2; rep++)
+                w.noalias() -= G.leftCols(j + 1) * (G.leftCols(j + 1).transpose() * w).eval();
+            Scalar beta = w.norm();
+            if(beta < prec)
+            {
+                // Lanczos breakdown, continue with any direction
+                // orthogonal to the previous ones
+                for(int t = 0; t < nr; t++)
+                {
+                    w.setZero();
+                    w[t] = 1;
+                    for(int rep = 0; rep < 2; rep++)
+                        w.noalias() -= G.leftCols(j + 1) * (G.leftCols(j + 1).transpose() * w).eval();
+                    beta = w.norm();
+                    if(beta > Scalar(0.5))
+                        break;
+                }
+            }
+            G.col(j + 1).noalias() = w / beta;
         }
-        Vs.col(k).noalias() = fac_V * Q.col(k);
-        fac_V.leftCols(k + 1).noalias() = Vs;
 
-        Vector fk = fac_f * Q(ncv - 1, k - 1) + fac_V.col(k) * fac_H(k, k - 1);
-        factorize_from(k, ncv, fk);
-        retrieve_ritzpair();
+        // New basis of the active columns: locked Ritz vectors first,
+        // then the re-tridiagonalized remainder
+        Matrix W(na, na);
+        for(int j = 0; j < nnew; j++)
+            W.col(j) = evecs.col(lock_ind[j]);
+        Matrix Sr(na, nr);
+        for(int j = 0; j < nr; j++)
+            Sr.col(j) = evecs.col(rest_ind[j]);
+        for(int j = 0; j < nr; j++)
+            W.col(nnew + j).noalias() = Sr * G.col(nr - 1 - j);
+
+        // V_active -> V_active * W
+        ws_Vs.leftCols(na).noalias() = fac_V.middleCols(nl, na) * W;
+        fac_V.middleCols(nl, na) = ws_Vs.leftCols(na);
+
+        // H_active -> W' * H_active * W, diagonal on the locked part and
+        // tridiagonal on the remainder (in reversed order, to match the
+        // reversed columns of G)
+        Matrix T = G.transpose() * (theta.asDiagonal() * G);
+        Ha.setZero();
+        for(int j = 0; j < nnew; j++)
+            Ha(j, j) = evals[lock_ind[j]];
+        for(int r = 0; r < nr; r++)
+            for(int s = 0; s < nr; s++)
+                Ha(nnew + r, nnew + s) = T(nr - 1 - r, nr - 1 - s);
+
+        nlocked += nnew;
     }
 
     // Calculate the number of converged Ritz values
     int num_converged(Scalar tol)
     {
         // thresh = tol * max(prec, abs(theta)), theta for ritz value
-        Array thresh = tol * ritz_val.head(nev).array().abs().max(prec);
-        Array resid =  ritz_vec.template bottomRows<1>().transpose().array().abs() * fac_f.norm();
+        // With per-position tolerances installed, each wanted Ritz pair
+        // is tested against its own tol instead of the uniform one
+        Array thresh(nev);
+        if(stop_tol.size() == nev)
+            thresh = stop_tol.array() * ritz_val.head(nev).array().abs().max(prec);
+        else
+            thresh = tol * ritz_val.head(nev).array().abs().max(prec);
+        Array resid = ritz_est.head(nev).array().abs() * global_norm(fac_f);
         // Converged "wanted" ritz values
         ritz_conv = (resid < thresh);
 
@@ -295,15 +606,91 @@ private:
         return nev_new;
     }
 
+    // Update the adaptive subspace size from the convergence progress.
+    // A window of restarts without any new converged pair means the
+    // subspace is too small to hold the wanted eigenvectors, while a
+    // window where every restart converges a new one means it is larger
+    // than needed. The growth is geometric, so the total resizing work
+    // stays amortized over the restarts that triggered it.
+    void tune_ncv(int nconv)
+    {
+        if(ncv_max <= 0)
+            return;
+
+        if(nconv > adapt_last)
+        {
+            adapt_stall = 0;
+            adapt_fast++;
+        } else {
+            adapt_stall++;
+            adapt_fast = 0;
+        }
+        adapt_last = nconv;
+
+        if(adapt_stall >= adapt_window && ncv < ncv_max)
+        {
+            ncv_next = std::min(ncv_max, ncv + ncv / 2 + 1);
+            adapt_stall = 0;
+        }
+        else if(adapt_fast >= adapt_window && ncv > ncv_min)
+        {
+            ncv_next = std::max(ncv_min, ncv - ncv / 4);
+            adapt_fast = 0;
+        }
+    }
+
+    // Move the factorization storage to a subspace of newncv columns.
+    // Only the leading basis columns and the top-left corner of H survive
+    // the compression in restart(), and the conservative resizes below
+    // preserve exactly the leading parts. This runs only between the
+    // restarts, so the factorization steps themselves stay allocation-free.
+    void resize_subspace(int newncv)
+    {
+        if(newncv > dim_n)
+            newncv = dim_n;
+        if(newncv == ncv)
+        {
+            ncv_next = ncv;
+            return;
+        }
+
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, newncv);
+        else
+        {
+            fac_V_data.conservativeResize(dim_n, newncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, newncv);
+        }
+        fac_H.conservativeResize(newncv, newncv);
+        ritz_val.conservativeResize(newncv);
+        ritz_est.conservativeResize(newncv);
+        ritz_vec.resize(newncv, nev);
+        ws_Vf.resize(newncv);
+        ws_Q.resize(newncv, newncv);
+        ws_Vs.resize(dim_n, newncv);
+        ws_ind.resize(newncv);
+        ws_ind2.resize(newncv);
+
+        ncv = newncv;
+        ncv_next = newncv;
+    }
+
     // Retrieve and sort ritz values and ritz vectors
-    void retrieve_ritzpair()
+    // When compute_vecs is false, only the Ritz values and the residual
+    // estimates in ritz_est are updated, which avoids the O(ncv^3)
+    // eigenvector accumulation on every restart
+    void retrieve_ritzpair(bool compute_vecs = true)
     {
-        TridiagEigen<double> decomp(fac_H);
-        Vector evals = decomp.eigenvalues();
-        Matrix evecs = decomp.eigenvectors();
+        double t_rz = StatsPolicy::wall_time();
+        // The decomposition object, the sorting machinery and the index
+        // vectors are all preallocated members, so this routine performs
+        // no memory allocation during the restart iterations
+        ws_eig.compute(fac_H, compute_vecs);
+        const SmallVector &evals = ws_eig.eigenvalues();
+        const SmallVector &brow = ws_eig.eigenvectors_bottom_row();
 
-        SortEigenvalue<Scalar, SelectionRule> sorting(evals.data(), evals.size());
-        std::vector<int> ind = sorting.index();
+        ws_sort.compute(evals.data(), ncv);
+        int *ind = &ws_ind[0];
 
         // For BOTH_ENDS, the eigenvalues are sorted according
         // to the LARGEST_ALGE rule, so we need to move those smallest
@@ -315,27 +702,36 @@ private:
         // or is nev (used in sort_ritzpair())
         if(SelectionRule == BOTH_ENDS)
         {
-            std::vector<int> ind_copy(ind);
+            ws_sort.index(&ws_ind2[0]);
             for(int i = 0; i < ncv; i++)
             {
                 // If i is even, pick values from the left (large values)
                 // If i is odd, pick values from the right (small values)
                 if(i % 2 == 0)
-                    ind[i] = ind_copy[i / 2];
+                    ind[i] = ws_ind2[i / 2];
                 else
-                    ind[i] = ind_copy[ncv - 1 - i / 2];
+                    ind[i] = ws_ind2[ncv - 1 - i / 2];
             }
+        } else {
+            ws_sort.index(ind);
         }
 
         // Copy the ritz values and vectors to ritz_val and ritz_vec, respectively
         for(int i = 0; i < ncv; i++)
         {
             ritz_val[i] = evals[ind[i]];
+            ritz_est[i] = brow[ind[i]];
         }
-        for(int i = 0; i < nev; i++)
+        if(compute_vecs)
         {
-            ritz_vec.col(i) = evecs.col(ind[i]);
+            const SmallMatrix &evecs = ws_eig.eigenvectors();
+            for(int i = 0; i < nev; i++)
+            {
+                ritz_vec.col(i) = evecs.col(ind[i]);
+            }
         }
+
+        stats_rec.add_ritz_time(StatsPolicy::wall_time() - t_rz);
     }
 
 protected:
@@ -344,22 +740,35 @@ protected:
     virtual void sort_ritzpair()
     {
         SortEigenvalue<Scalar, LARGEST_ALGE> sorting(ritz_val.data(), nev);
-        std::vector<int> ind = sorting.index();
-
-        Vector new_ritz_val(ncv);
-        Matrix new_ritz_vec(ncv, nev);
-        BoolArray new_ritz_conv(nev);
+        sorting.index(&ws_ind[0]);
 
+        // Apply the permutation in place by following its cycles, so that
+        // no new containers need to be allocated. ws_Vf serves as the
+        // temporary for the eigenvector column being moved.
         for(int i = 0; i < nev; i++)
         {
-            new_ritz_val[i] = ritz_val[ind[i]];
-            new_ritz_vec.col(i) = ritz_vec.col(ind[i]);
-            new_ritz_conv[i] = ritz_conv[ind[i]];
+            if(ws_ind[i] == i)
+                continue;
+
+            Scalar val = ritz_val[i];
+            bool conv = ritz_conv[i];
+            ws_Vf.noalias() = ritz_vec.col(i);
+            int j = i;
+            for(;;)
+            {
+                const int k = ws_ind[j];
+                ws_ind[j] = j;
+                if(k == i)
+                    break;
+                ritz_val[j] = ritz_val[k];
+                ritz_conv[j] = ritz_conv[k];
+                ritz_vec.col(j) = ritz_vec.col(k);
+                j = k;
+            }
+            ritz_val[j] = val;
+            ritz_conv[j] = conv;
+            ritz_vec.col(j) = ws_Vf;
         }
-
-        ritz_val.swap(new_ritz_val);
-        ritz_vec.swap(new_ritz_vec);
-        ritz_conv.swap(new_ritz_conv);
     }
 
 public:
@@ -385,15 +794,80 @@ public:
         dim_n(op->rows()),
         nev(nev_),
         ncv(ncv_ > dim_n ? dim_n : ncv_),
+        ncv_min(0),
+        ncv_max(0),
+        adapt_window(5),
+        ncv_next(ncv),
+        nmatop(0),
+        niter(0),
+        basis_ptr(NULL),
+        fac_V(NULL, 0, 0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD),
+        stop_minconv(0),
+        stop_maxtime(0.0),
+        stop_callback(NULL),
+        stop_callback_data(NULL),
+        reduce_hook(NULL),
+        reduce_hook_data(NULL)
+    {
+        if(nev_ < 1 || nev_ > dim_n - 1)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
+
+        if(ncv_ <= nev_ || ncv_ > dim_n)
+            throw std::invalid_argument("ncv must satisfy nev < ncv <= n, n is the size of matrix");
+
+        if(MaxNcv != Eigen::Dynamic && ncv > MaxNcv)
+            throw std::invalid_argument("ncv exceeds the MaxNcv template parameter");
+    }
+
+    ///
+    /// Constructor to create a solver object whose Arnoldi basis lives in a
+    /// caller-supplied buffer instead of an internally allocated matrix.
+    /// The buffer may come from a memory-mapped file (see MMapBasisStorage)
+    /// or from a user allocator, which allows solving problems whose
+    /// \f$n\times ncv\f$ basis does not fit in RAM.
+    ///
+    /// \param op_    Pointer to the matrix operation object, see above.
+    /// \param nev_   Number of eigenvalues requested.
+    /// \param ncv_   Parameter that controls the convergence speed, see above.
+    /// \param basis_ Pointer to a buffer of at least \f$n\times ncv\f$
+    ///               scalars holding the basis, in column-major order. It
+    ///               must stay valid for the lifetime of the solver.
+    ///
+    SymEigsSolver(OpType *op_, int nev_, int ncv_, Scalar *basis_) :
+        op(op_),
+        dim_n(op->rows()),
+        nev(nev_),
+        ncv(ncv_ > dim_n ? dim_n : ncv_),
+        ncv_min(0),
+        ncv_max(0),
+        adapt_window(5),
+        ncv_next(ncv),
         nmatop(0),
         niter(0),
-        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3))
+        basis_ptr(basis_),
+        fac_V(NULL, 0, 0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD),
+        stop_minconv(0),
+        stop_maxtime(0.0),
+        stop_callback(NULL),
+        stop_callback_data(NULL),
+        reduce_hook(NULL),
+        reduce_hook_data(NULL)
     {
         if(nev_ < 1 || nev_ > dim_n - 1)
             throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
 
         if(ncv_ <= nev_ || ncv_ > dim_n)
             throw std::invalid_argument("ncv must satisfy nev < ncv <= n, n is the size of matrix");
+
+        if(MaxNcv != Eigen::Dynamic && ncv > MaxNcv)
+            throw std::invalid_argument("ncv exceeds the MaxNcv template parameter");
+
+        if(basis_ == NULL)
+            throw std::invalid_argument("basis buffer cannot be NULL");
     }
 
     ///
@@ -408,36 +882,63 @@ public:
     void init(const Scalar *init_resid)
     {
         // Reset all matrices/vectors to zero
-        fac_V.resize(dim_n, ncv);
+        // The basis either lives in the caller-supplied buffer or in an
+        // internally allocated matrix
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, ncv);
+        else
+        {
+            fac_V_data.resize(dim_n, ncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, ncv);
+        }
         fac_H.resize(ncv, ncv);
         fac_f.resize(dim_n);
         ritz_val.resize(ncv);
         ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
         ritz_conv.resize(nev);
 
+        // Allocate the workspace here, so that the iterations
+        // can run without any memory allocation
+        ws_w.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_ind.resize(ncv);
+        ws_ind2.resize(ncv);
+
         fac_V.setZero();
         fac_H.setZero();
         fac_f.setZero();
         ritz_val.setZero();
         ritz_vec.setZero();
+        ritz_est.setZero();
         ritz_conv.setZero();
 
         nmatop = 0;
         niter = 0;
+        nlocked = 0;
+        ncv_next = ncv;
+        adapt_last = 0;
+        adapt_stall = 0;
+        adapt_fast = 0;
+        stats_rec.reset();
 
         Vector v(dim_n);
         std::copy(init_resid, init_resid + dim_n, v.data());
-        Scalar vnorm = v.norm();
+        Scalar vnorm = global_norm(v);
         if(vnorm < prec)
             throw std::invalid_argument("initial residual vector cannot be zero");
         v /= vnorm;
 
-        Vector w(dim_n);
-        op->perform_op(v.data(), w.data());
+        double t_op = StatsPolicy::wall_time();
+        op->perform_op(v.data(), ws_w.data());
         nmatop++;
+        stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
 
-        fac_H(0, 0) = v.dot(w);
-        fac_f = w - v * fac_H(0, 0);
+        fac_H(0, 0) = global_dot(v, ws_w);
+        fac_f = ws_w - v * fac_H(0, 0);
         fac_V.col(0) = v;
     }
 
@@ -455,6 +956,27 @@ public:
         init(init_resid.data());
     }
 
+    ///
+    /// Providing a warm-start basis for the algorithm.
+    ///
+    /// \param basis Pointer to a \f$n\times ncols\f$ matrix stored in
+    ///              column-major order, typically the eigenvectors computed
+    ///              from a nearby matrix.
+    /// \param ncols Number of columns of the basis.
+    ///
+    /// The columns are combined into the initial residual vector, so the
+    /// iterations start with no component outside the span of the basis.
+    /// When solving a sequence of slowly-varying matrices, seeding each
+    /// solve with the eigenvectors of the previous one in this way can cut
+    /// the iteration count several-fold.
+    ///
+    void init(const Scalar *basis, int ncols)
+    {
+        MapMat V(const_cast<Scalar *>(basis), dim_n, ncols);
+        Vector v0 = V.rowwise().sum();
+        init(v0.data());
+    }
+
     ///
     /// Conducting the major computation procedure.
     ///
@@ -466,27 +988,157 @@ public:
     int compute(int maxit = 1000, Scalar tol = 1e-10)
     {
         // The m-step Arnoldi factorization
-        factorize_from(1, ncv, fac_f);
-        retrieve_ritzpair();
+        // ws_fk is used here since factorize_from() overwrites fac_f
+        ws_fk = fac_f;
+        factorize_from(1, ncv, ws_fk);
+        niter++;
+
+        return compute_continue(maxit, tol);
+    }
+
+    ///
+    /// Resuming the computation from the current Arnoldi factorization,
+    /// without rebuilding it from the initial residual vector. It can be
+    /// called after compute() has exhausted its iteration allowance, or
+    /// after load_state() has restored a checkpointed factorization, and
+    /// all the progress made before is kept.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute_continue(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        retrieve_ritzpair(false);
+        const double t_start = (stop_maxtime > 0) ? SolverStats<Scalar>::wall_time() : 0.0;
         // Restarting
         int i, nconv = 0, nev_adj;
         for(i = 0; i < maxit; i++)
         {
             nconv = num_converged(tol);
+            // The residual norms below are only computed when a recording
+            // statistics policy is in use
+            if(StatsPolicy::enabled)
+                stats_rec.iteration(niter + i, nconv,
+                    (ritz_est.head(nev).array().abs() * global_norm(fac_f)).maxCoeff());
+            // User-installed per-restart callback; it can abort the
+            // iterations by returning false
+            bool user_abort = false;
+            if(stop_callback != NULL)
+            {
+                ws_resid = (ritz_est.head(nev).array().abs() * global_norm(fac_f)).matrix();
+                user_abort = !stop_callback(niter + i, nconv, ritz_val.data(),
+                                            ws_resid.data(), nev, stop_callback_data);
+            }
             if(nconv >= nev)
                 break;
+            if(user_abort)
+                break;
+            // Early-exit stopping rule: enough of the wanted values have
+            // converged, or the wall-clock budget has been used up
+            if(stop_minconv > 0 && nconv >= stop_minconv)
+                break;
+            if(stop_maxtime > 0 && SolverStats<Scalar>::wall_time() - t_start >= stop_maxtime)
+                break;
 
+            // Freeze converged wanted Ritz pairs, so that the restart
+            // below only works on the active part of the factorization.
+            // Skipped unless a new pair has converged since the last
+            // locking, to keep the O(ncv^3) decomposition it performs
+            // out of the plain iterations
+            if(nconv > nlocked)
+                lock_converged(tol);
+            tune_ncv(nconv);
             nev_adj = nev_adjusted(nconv);
             restart(nev_adj);
         }
+        // The iterations above only work with Ritz values and residual
+        // estimates; compute the full Ritz vectors once at the end
+        retrieve_ritzpair(true);
+        nconv = num_converged(tol);
         // Sorting results
         sort_ritzpair();
 
-        niter += i + 1;
+        niter += i;
 
         return std::min(nev, nconv);
     }
 
+    ///
+    /// Returning the number of scalars needed by save_state() to checkpoint
+    /// the Arnoldi factorization.
+    ///
+    int state_size() const { return dim_n * ncv + ncv * ncv + dim_n; }
+
+    ///
+    /// Saving the current Arnoldi factorization to a user buffer, so that
+    /// an interrupted solve can later be resumed by load_state() and
+    /// compute_continue(), possibly in another process.
+    ///
+    /// \param buffer Pointer to a buffer of at least state_size() scalars.
+    ///
+    void save_state(Scalar *buffer) const
+    {
+        std::copy(fac_V.data(), fac_V.data() + dim_n * ncv, buffer);
+        buffer += dim_n * ncv;
+        std::copy(fac_H.data(), fac_H.data() + ncv * ncv, buffer);
+        buffer += ncv * ncv;
+        std::copy(fac_f.data(), fac_f.data() + dim_n, buffer);
+    }
+
+    ///
+    /// Restoring an Arnoldi factorization saved by save_state(). The solver
+    /// must have been created with the same operation object dimension and
+    /// the same ncv parameter. Use compute_continue() afterwards to resume
+    /// the computation.
+    ///
+    /// \param buffer Pointer to the buffer filled by save_state().
+    ///
+    void load_state(const Scalar *buffer)
+    {
+        if(basis_ptr != NULL)
+            new (&fac_V) MapMat(basis_ptr, dim_n, ncv);
+        else
+        {
+            fac_V_data.resize(dim_n, ncv);
+            new (&fac_V) MapMat(fac_V_data.data(), dim_n, ncv);
+        }
+        fac_H.resize(ncv, ncv);
+        fac_f.resize(dim_n);
+        ritz_val.resize(ncv);
+        ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
+        ritz_conv.resize(nev);
+
+        ws_w.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_ind.resize(ncv);
+        ws_ind2.resize(ncv);
+
+        ritz_val.setZero();
+        ritz_vec.setZero();
+        ritz_est.setZero();
+        ritz_conv.setZero();
+
+        nmatop = 0;
+        niter = 0;
+        nlocked = 0;
+        ncv_next = ncv;
+        adapt_last = 0;
+        adapt_stall = 0;
+        adapt_fast = 0;
+
+        std::copy(buffer, buffer + dim_n * ncv, fac_V.data());
+        buffer += dim_n * ncv;
+        std::copy(buffer, buffer + ncv * ncv, fac_H.data());
+        buffer += ncv * ncv;
+        std::copy(buffer, buffer + dim_n, fac_f.data());
+    }
+
     ///
     /// Returning the number of iterations used in the computation.
     ///
@@ -497,6 +1149,198 @@ public:
     ///
     int num_operations() { return nmatop; }
 
+    ///
+    /// Returning the statistics object of the solver. For the default
+    /// NullSolverStats policy this object records nothing; instantiate the
+    /// solver with SolverStats as the `StatsPolicy` template parameter to
+    /// obtain per-phase wall times, reorthogonalization and restart counts,
+    /// and the per-iteration residual norms. The reference is mutable so
+    /// that a per-iteration callback can be installed before compute().
+    ///
+    StatsPolicy & stats() { return stats_rec; }
+
+    ///
+    /// Selecting the reorthogonalization strategy used in the Arnoldi
+    /// factorization. The full list of enumeration values can be found in
+    /// ReorthRule.h . The default REORTH_STANDARD keeps the behavior of
+    /// earlier versions; REORTH_DGKS is recommended for ill-conditioned
+    /// operators, where the standard test may fail to restore
+    /// orthogonality and cause spurious extra restarts.
+    ///
+    /// \param rule One of the `REORTH_*` enumeration values.
+    ///
+    void set_reorth_rule(int rule) { reorth_rule = rule; }
+
+    ///
+    /// The type of the per-restart callback installed by
+    /// set_iteration_callback(). It receives the iteration number, the
+    /// number of converged Ritz values, pointers to the current `nvals`
+    /// wanted Ritz values and their residual estimates, and the opaque
+    /// user data pointer. Returning `false` aborts the iterations; the
+    /// pairs converged so far remain available through the usual
+    /// retrieval methods.
+    ///
+    typedef bool (*IterationCallback)(int iter, int nconv, const Scalar *ritz_val,
+                                      const Scalar *resid_est, int nvals, void *data);
+
+    ///
+    /// Setting an early-exit stopping rule for compute(). The iterations
+    /// end as soon as `min_conv` of the requested eigenvalues have
+    /// converged, or once `max_time` seconds of wall-clock time have been
+    /// spent, whichever comes first. This is useful when a larger `nev`
+    /// is requested for robustness but only the leading few values are
+    /// actually consumed, or when the solve has a latency budget.
+    ///
+    /// \param min_conv Number of converged eigenvalues that is good
+    ///                 enough to stop, `0 <= min_conv <= nev`. Zero (the
+    ///                 default) disables the rule and iterates until all
+    ///                 `nev` have converged.
+    /// \param max_time Wall-clock budget in seconds, checked once per
+    ///                 restart. Zero (the default) means unlimited.
+    ///
+    void set_stop_rule(int min_conv, double max_time = 0.0)
+    {
+        if(min_conv < 0 || min_conv > nev)
+            throw std::invalid_argument("min_conv must satisfy 0 <= min_conv <= nev");
+        if(max_time < 0)
+            throw std::invalid_argument("max_time must be non-negative");
+
+        stop_minconv = min_conv;
+        stop_maxtime = max_time;
+    }
+
+    ///
+    /// Installing per-Ritz-position tolerances. Position `i` of the
+    /// sorted wanted values is tested against `tol_vals[i]` instead of
+    /// the uniform `tol` argument of compute(), so the leading values can
+    /// be required to a tight tolerance while the trailing ones are
+    /// accepted loosely.
+    ///
+    /// \param tol_vals Pointer to `nev` tolerances, copied internally.
+    ///                 Passing `NULL` removes previously installed
+    ///                 tolerances.
+    ///
+    void set_stop_tolerances(const Scalar *tol_vals)
+    {
+        if(tol_vals == NULL)
+        {
+            stop_tol.resize(0);
+            return;
+        }
+        stop_tol.resize(nev);
+        std::copy(tol_vals, tol_vals + nev, stop_tol.data());
+    }
+
+    ///
+    /// Installing a callback that is invoked once per restart iteration
+    /// of compute() with the current Ritz values and residual estimates,
+    /// so that the caller can observe convergence or abort the solve by
+    /// returning `false` from the callback.
+    ///
+    /// \param cb   The callback function, or `NULL` to remove it.
+    /// \param data Opaque pointer passed through to every invocation.
+    ///
+    void set_iteration_callback(IterationCallback cb, void *data = NULL)
+    {
+        stop_callback = cb;
+        stop_callback_data = data;
+        ws_resid.resize(nev);
+    }
+
+    ///
+    /// The type of the reduction hook installed by set_reduction_hook().
+    /// It must replace the `len` scalars in `buf` by their element-wise
+    /// sum over all ranks (an in-place all-reduce), on every rank.
+    ///
+    typedef void (*ReductionHook)(Scalar *buf, int len, void *data);
+
+    ///
+    /// Switching the solver to distributed mode by installing an
+    /// all-reduce hook. Each rank then owns a contiguous row slice of the
+    /// problem: the matrix operation object reports the **local** number
+    /// of rows, receives the local slice of \f$x\f$ and must return the
+    /// local slice of \f$Ax\f$, performing whatever halo exchange its
+    /// matrix distribution requires. All inner products and norms of
+    /// length-\f$n\f$ vectors inside the solver are computed on the local
+    /// slices and combined through the hook, while the small
+    /// \f$ncv\times ncv\f$ quantities — `fac_H`, the QR sweeps and the
+    /// tridiagonal eigen decomposition — stay replicated on every rank.
+    /// Since the reduced scalars are identical everywhere, the ranks make
+    /// identical control-flow decisions and no further synchronization is
+    /// needed; eigenvectors() returns the local row slice of the result.
+    ///
+    /// Every rank must construct the solver with the same `nev` and `ncv`
+    /// and install the same hook (and the same stopping rules and
+    /// callbacks, if any). A typical MPI hook is
+    ///
+    /// \code{.cpp}
+    /// void mpi_allreduce_hook(double *buf, int len, void *data)
+    /// {
+    ///     MPI_Allreduce(MPI_IN_PLACE, buf, len, MPI_DOUBLE, MPI_SUM,
+    ///                   *static_cast<MPI_Comm *>(data));
+    /// }
+    /// \endcode
+    ///
+    /// \param hook The reduction hook, or `NULL` to return to the
+    ///             single-process mode.
+    /// \param data Opaque pointer passed through to every invocation,
+    ///             e.g. the communicator.
+    ///
+    void set_reduction_hook(ReductionHook hook, void *data = NULL)
+    {
+        reduce_hook = hook;
+        reduce_hook_data = data;
+    }
+
+    ///
+    /// Enabling adaptive tuning of the subspace size (the `ncv` parameter)
+    /// across the restarts. The solver keeps the size it was constructed
+    /// with until the convergence history says otherwise: a window of
+    /// restarts without any new converged eigenvalue grows the subspace
+    /// geometrically toward `max_ncv`, and a window where every restart
+    /// converges a new one shrinks it toward `min_ncv`, cutting the
+    /// \f$O(n\cdot ncv)\f$ orthogonalization work and the \f$O(ncv^3)\f$
+    /// restart work per iteration. The optimal `ncv` varies widely between
+    /// matrix families, and this mode removes the need to provision for
+    /// the worst case.
+    ///
+    /// This function must be called before init(). When the basis lives
+    /// in a caller-supplied buffer, the buffer must hold at least
+    /// \f$n\times max\_ncv\f$ scalars, since the basis may grow into it.
+    ///
+    /// \param min_ncv Lower bound of the subspace size. This should satisfy
+    ///                \f$nev < min\_ncv \le max\_ncv\f$.
+    /// \param max_ncv Upper bound of the subspace size. This should satisfy
+    ///                \f$max\_ncv \le n\f$, where \f$n\f$ is the size of matrix.
+    /// \param window  Number of consecutive restarts observed before each
+    ///                adjustment.
+    ///
+    void set_ncv_bounds(int min_ncv, int max_ncv, int window = 5)
+    {
+        if(min_ncv <= nev || min_ncv > max_ncv || max_ncv > dim_n)
+            throw std::invalid_argument("ncv bounds must satisfy nev < min_ncv <= max_ncv <= n, n is the size of matrix");
+
+        if(MaxNcv != Eigen::Dynamic && max_ncv > MaxNcv)
+            throw std::invalid_argument("max_ncv exceeds the MaxNcv template parameter");
+
+        if(window < 1)
+            throw std::invalid_argument("window must be at least one restart");
+
+        ncv_min = min_ncv;
+        ncv_max = max_ncv;
+        adapt_window = window;
+        if(ncv < ncv_min)  ncv = ncv_min;
+        if(ncv > ncv_max)  ncv = ncv_max;
+        ncv_next = ncv;
+    }
+
+    ///
+    /// Returning the current size of the working subspace. This equals the
+    /// `ncv` parameter given to the constructor, unless adaptive tuning
+    /// has been enabled through set_ncv_bounds() and has moved it.
+    ///
+    int subspace_size() { return ncv; }
+
     ///
     /// Returning the converged eigenvalues.
     ///
@@ -509,22 +1353,39 @@ public:
         int nconv = ritz_conv.cast<int>().sum();
         Vector res(nconv);
 
-        if(!nconv)
-            return res;
+        if(nconv)
+            eigenvalues(res.data());
 
+        return res;
+    }
+
+    ///
+    /// Writing the converged eigenvalues directly into a caller-supplied
+    /// buffer, avoiding the allocation of the returned vector.
+    ///
+    /// \param dest Pointer to a buffer of at least num_converged_eigenvalues()
+    ///             scalars.
+    ///
+    void eigenvalues(Scalar *dest)
+    {
         int j = 0;
         for(int i = 0; i < nev; i++)
         {
             if(ritz_conv[i])
             {
-                res[j] = ritz_val[i];
+                dest[j] = ritz_val[i];
                 j++;
             }
         }
-
-        return res;
     }
 
+    ///
+    /// Returning the number of converged eigenvalues, i.e. the number of
+    /// values written by eigenvalues(Scalar *) and the maximum number of
+    /// columns written by eigenvectors(Scalar *, int).
+    ///
+    int num_converged_eigenvalues() { return ritz_conv.cast<int>().sum(); }
+
     ///
     /// Returning the eigenvectors associated with the converged eigenvalues.
     ///
@@ -540,8 +1401,38 @@ public:
         nvec = std::min(nvec, nconv);
         Matrix res(dim_n, nvec);
 
+        if(nvec)
+            eigenvectors(res.data(), nvec);
+
+        return res;
+    }
+
+    ///
+    /// Returning all converged eigenvectors.
+    ///
+    Matrix eigenvectors()
+    {
+        return eigenvectors(nev);
+    }
+
+    ///
+    /// Writing the converged eigenvectors directly into a caller-supplied
+    /// buffer, so that no \f$n\times nvec\f$ matrix is allocated or copied.
+    /// The product of the basis and the Ritz coefficients is evaluated
+    /// straight into the destination; the only temporary is the small
+    /// \f$ncv\times nvec\f$ gather of the converged coefficient columns.
+    ///
+    /// \param dest Pointer to a buffer of at least \f$n\times nvec\f$
+    ///             scalars, which will be filled in column-major order.
+    /// \param nvec The number of eigenvectors to write. It is capped by the
+    ///             number of converged eigenvalues.
+    ///
+    void eigenvectors(Scalar *dest, int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
         if(!nvec)
-            return res;
+            return;
 
         Matrix ritz_vec_conv(ncv, nvec);
         int j = 0;
@@ -554,17 +1445,31 @@ public:
             }
         }
 
+        MapMat res(dest, dim_n, nvec);
         res.noalias() = fac_V * ritz_vec_conv;
+    }
 
-        return res;
+    ///
+    /// Returning a read-only view of the basis \f$V\f$ of the Arnoldi
+    /// factorization, without copying it. Together with ritz_vectors(),
+    /// consumers that only need a few eigenvector columns can form
+    /// `basis() * ritz_vectors().col(i)` lazily instead of materializing
+    /// all of them.
+    ///
+    Eigen::Map<const Matrix> basis()
+    {
+        return Eigen::Map<const Matrix>(fac_V.data(), dim_n, ncv);
     }
 
     ///
-    /// Returning all converged eigenvectors.
+    /// Returning a read-only view of the Ritz coefficient vectors, i.e. the
+    /// coordinates of the Ritz vectors in the basis \f$V\f$. Column \f$i\f$
+    /// corresponds to the \f$i\f$-th value of the sorted Ritz values, and
+    /// only converged columns represent eigenvectors.
     ///
-    Matrix eigenvectors()
+    Eigen::Map<const Matrix> ritz_vectors()
     {
-        return eigenvectors(nev);
+        return Eigen::Map<const Matrix>(ritz_vec.data(), ncv, nev);
     }
 };
 
@@ -699,8 +1604,10 @@ public:
 ///
 template <typename Scalar = double,
           int SelectionRule = LARGEST_MAGN,
-          typename OpType = DenseSymShiftSolve<double> >
-class SymEigsShiftSolver: public SymEigsSolver<Scalar, SelectionRule, OpType>
+          typename OpType = DenseSymShiftSolve<double>,
+          typename StatsPolicy = NullSolverStats<Scalar>,
+          int MaxNcv = Eigen::Dynamic >
+class SymEigsShiftSolver: public SymEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, MaxNcv>
 {
 private:
     typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
@@ -712,7 +1619,7 @@ private:
     {
         Array ritz_val_org = Scalar(1.0) / this->ritz_val.head(this->nev).array() + sigma;
         this->ritz_val.head(this->nev) = ritz_val_org;
-        SymEigsSolver<Scalar, SelectionRule, OpType>::sort_ritzpair();
+        SymEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, MaxNcv>::sort_ritzpair();
     }
 public:
     ///
@@ -734,7 +1641,7 @@ public:
     /// \param sigma_ The value of the shift.
     ///
     SymEigsShiftSolver(OpType *op_, int nev_, int ncv_, Scalar sigma_) :
-        SymEigsSolver<Scalar, SelectionRule, OpType>(op_, nev_, ncv_),
+        SymEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy, MaxNcv>(op_, nev_, ncv_),
         sigma(sigma_)
     {
         this->op->set_shift(sigma);
@@ -0,0 +1,807 @@
+// Copyright (C) 2015 Yixuan Qiu <yixuan.qiu@cos.name>
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SYM_GEIGS_SOLVER_H
+#define SYM_GEIGS_SOLVER_H
+
+#include <Eigen/Core>
+#include <vector>     // std::vector
+#include <cmath>      // std::abs, std::sqrt, std::pow
+#include <algorithm>  // std::min, std::copy
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+
+#include "SelectionRule.h"
+#include "ReorthRule.h"
+#include "SolverStats.h"
+#include "UpperHessenbergQR.h"
+#include "TridiagEigen.h"
+#include "MatOp/SparseSymGenRegInvSolve.h"
+#include "MatOp/SparseSymGenShiftSolve.h"
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements the eigen solver for the generalized eigen
+/// problem \f$Ax=\lambda Bx\f$ with real symmetric \f$A\f$ and positive
+/// definite \f$B\f$, in the **regular inverse mode**.
+///
+/// The problem is turned into the standard one \f$B^{-1}Ax=\lambda x\f$,
+/// but \f$B^{-1}A\f$ is not symmetric in the Euclidean inner product, so
+/// the Lanczos recurrence here uses the \f$B\f$-inner product
+/// \f$\langle u,v\rangle_B=u'Bv\f$ instead: the projections, the
+/// normalization of the basis vectors and the reorthogonalization
+/// corrections all go through \f$B\f$, under which \f$B^{-1}A\f$ is
+/// self-adjoint and the projected matrix stays real tridiagonal. The
+/// TridiagEigen decomposition and the TridiagQR restart sweeps of the
+/// standard solver are reused unchanged. Neither \f$B^{-1}\f$ nor any
+/// dense transformation of \f$A\f$ is ever formed — the matrix operation
+/// object applies a cached sparse Cholesky factorization of \f$B\f$, so
+/// the sparsity of both matrices is fully preserved.
+///
+/// The computed eigenvectors are \f$B\f$-orthonormal, i.e.
+/// \f$V'BV=I\f$, which is the natural normalization for the generalized
+/// problem (e.g. mass-normalized mode shapes in structural analysis).
+///
+/// \tparam Scalar        The element type of the matrix.
+///                       Currently supported types are `float`, `double` and `long double`.
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the requested eigenvalues, for example `LARGEST_MAGN`
+///                       to retrieve eigenvalues with the largest magnitude.
+///                       The full list of enumeration values can be found in
+///                       SelectionRule.h .
+/// \tparam OpType        The name of the matrix operation class. Users could
+///                       either use the SparseSymGenRegInvSolve wrapper class,
+///                       or define their own that impelemnts the \f$B^{-1}A\f$
+///                       product in perform_op() and the \f$B\f$ product in
+///                       perform_B_op().
+/// \tparam StatsPolicy   The statistics policy class. The default NullSolverStats
+///                       compiles all instrumentation out; passing SolverStats
+///                       instead makes the solver record per-phase wall time and
+///                       event counts, accessible through the stats() member.
+///
+/// Below is an example that demonstrates the usage of this class.
+///
+/// \code{.cpp}
+/// #include <Eigen/Core>
+/// #include <Eigen/SparseCore>
+/// #include <SymGEigsSolver.h>  // Also includes <MatOp/SparseSymGenRegInvSolve.h>
+/// #include <iostream>
+///
+/// int main()
+/// {
+///     // Sparse stiffness matrix A and mass matrix B, assembled elsewhere
+///     Eigen::SparseMatrix<double> A = ...;
+///     Eigen::SparseMatrix<double> B = ...;
+///
+///     // B is factorized once here
+///     SparseSymGenRegInvSolve<double> op(A, B);
+///
+///     // Find the three largest generalized eigenvalues
+///     SymGEigsSolver< double, LARGEST_MAGN,
+///                     SparseSymGenRegInvSolve<double> > eigs(&op, 3, 6);
+///
+///     eigs.init();
+///     int nconv = eigs.compute();
+///
+///     Eigen::VectorXd evalues;
+///     if(nconv > 0)
+///         evalues = eigs.eigenvalues();
+///
+///     std::cout << "Eigenvalues found:\n" << evalues << std::endl;
+///
+///     return 0;
+/// }
+/// \endcode
+///
+template < typename Scalar = double,
+           int SelectionRule = LARGEST_MAGN,
+           typename OpType = SparseSymGenRegInvSolve<double>,
+           typename StatsPolicy = NullSolverStats<Scalar> >
+class SymGEigsSolver
+{
+private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
+    typedef Eigen::Array<bool, Eigen::Dynamic, 1> BoolArray;
+    typedef Eigen::Map<Matrix> MapMat;
+
+protected:
+    OpType *op;          // object to conduct matrix operation,
+                         // e.g. matrix-vector product
+    const int dim_n;     // dimension of matrix A
+    const int nev;       // number of eigenvalues requested
+
+private:
+    const int ncv;       // number of ritz values
+    int nmatop;          // number of matrix operations called
+    int niter;           // number of restarting iterations
+
+    Matrix fac_V;        // V matrix in the Lanczos factorization;
+                         // B-orthonormal, V'BV = I
+    Matrix fac_H;        // H matrix in the Lanczos factorization;
+                         // real tridiagonal, as in SymEigsSolver
+    Vector fac_f;        // residual in the Lanczos factorization
+
+protected:
+    Vector ritz_val;     // ritz values
+
+private:
+    Matrix ritz_vec;     // ritz vectors
+    Vector ritz_est;     // last row of the eigenvector matrix of fac_H,
+                         // used to estimate residuals during the restart
+                         // iterations without computing full Ritz vectors
+    BoolArray ritz_conv; // indicator of the convergence of ritz values
+
+    const Scalar prec;   // precision parameter used to test convergence
+                         // prec = epsilon^(2/3)
+                         // epsilon is the machine precision,
+                         // e.g. ~= 1e-16 for the "double" type
+
+    int reorth_rule;     // reorthogonalization strategy, one of the
+                         // REORTH_* enumeration values
+
+    // Preallocated workspace, sized once in init(), so that the hot-path
+    // routines below do not touch the heap during the iterations
+    Vector ws_w;               // length-n scratch to receive perform_op() results
+    Vector ws_Bv;              // length-n scratch holding B times a vector
+    Vector ws_Vf;              // coefficients in the reorthogonalization step
+    Vector ws_fk;              // new residual vector computed in restart()
+    Matrix ws_Q;               // accumulated rotation matrix in restart()
+    Matrix ws_Vs;              // new basis columns computed in restart()
+    TridiagQR<Scalar> ws_decomp;  // QR decomposition reused for all shifts
+    TridiagEigen<Scalar> ws_eig;  // eigen decomposition of fac_H, reused
+                                  // across the restarts
+    SortEigenvalue<Scalar, SelectionRule> ws_sort;  // sorting machinery,
+                                                    // reused across the restarts
+    std::vector<int> ws_ind;      // order index of the Ritz values
+    std::vector<int> ws_ind2;     // scratch for the BOTH_ENDS reordering
+
+    StatsPolicy stats_rec;     // per-phase statistics, a no-op recorder
+                               // by default
+
+    // B-norm of a vector, computed through a B product into ws_Bv.
+    // The absolute value guards against tiny negative rounding results
+    Scalar b_norm(Vector &v)
+    {
+        op->perform_B_op(v.data(), ws_Bv.data());
+        return std::sqrt(std::abs(v.dot(ws_Bv)));
+    }
+
+    // Lanczos factorization starting from step-k, carried out in the
+    // B-inner product
+    void factorize_from(int from_k, int to_m, const Vector &fk)
+    {
+        if(to_m <= from_k) return;
+
+        fac_f = fk;
+
+        Scalar beta = 0.0, Hii = 0.0;
+        // Keep the upperleft k x k submatrix of H and set other elements to 0
+        fac_H.rightCols(ncv - from_k).setZero();
+        fac_H.block(from_k, 0, ncv - from_k, from_k).setZero();
+        for(int i = from_k; i <= to_m - 1; i++)
+        {
+            beta = b_norm(fac_f);
+            fac_V.col(i).noalias() = fac_f / beta; // The (i+1)-th column
+            fac_H(i, i - 1) = beta;
+
+            // For the default NullSolverStats policy, wall_time() is an
+            // inline constant and the add_*() calls are empty, so the
+            // timing code below disappears at compile time
+            double t_op = StatsPolicy::wall_time();
+            op->perform_op(&fac_V(0, i), ws_w.data());
+            nmatop++;
+            stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
+
+            // Hii = <v, w>_B = v' B w
+            op->perform_B_op(ws_w.data(), ws_Bv.data());
+            Hii = fac_V.col(i).dot(ws_Bv);
+            fac_H(i - 1, i) = beta;
+            fac_H(i, i) = Hii;
+
+            fac_f.noalias() = ws_w - beta * fac_V.col(i - 1) - Hii * fac_V.col(i);
+            reorthogonalize(i + 1);
+        }
+    }
+
+    // One classical Gram-Schmidt correction pass of fac_f against the
+    // first ncols basis columns, in the B-inner product: the projection
+    // coefficients are V' (B f), and the update is the usual panel GEMV
+    void reorth_pass(int ncols)
+    {
+        op->perform_B_op(fac_f.data(), ws_Bv.data());
+        ws_Vf.head(ncols).noalias() = fac_V.leftCols(ncols).transpose() * ws_Bv;
+        fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+    }
+
+    // Orthogonality maintenance of fac_f against the first ncols basis
+    // columns, following the strategy selected by reorth_rule
+    void reorthogonalize(int ncols)
+    {
+        if(reorth_rule == REORTH_NONE)
+            return;
+
+        double t_re = StatsPolicy::wall_time();
+        if(reorth_rule == REORTH_FULL)
+        {
+            stats_rec.reorth_hit();
+            reorth_pass(ncols);
+        }
+        else if(reorth_rule == REORTH_DGKS)
+        {
+            // Iterated CGS with the eta test of Daniel, Gragg, Kaufman
+            // and Stewart, using the B-norms of the vectors
+            const Scalar eta = Scalar(1) / std::sqrt(Scalar(2));
+            Scalar last = b_norm(ws_w);
+            Scalar fnorm = b_norm(fac_f);
+            for(int pass = 0; pass < 3 && fnorm < eta * last; pass++)
+            {
+                stats_rec.reorth_hit();
+                reorth_pass(ncols);
+                last = fnorm;
+                fnorm = b_norm(fac_f);
+            }
+        }
+        else  // REORTH_STANDARD
+        {
+            // Correct f if it is not B-orthogonal to V
+            // Typically the largest absolute value occurs in
+            // the first element, i.e., <v1, f>_B, so we use this
+            // to test the orthogonality
+            op->perform_B_op(fac_f.data(), ws_Bv.data());
+            Scalar v1f = ws_Bv.dot(fac_V.col(0));
+            if(v1f > prec || v1f < -prec)
+            {
+                ws_Vf.segment(1, ncols - 1).noalias() = fac_V.block(0, 1, dim_n, ncols - 1).transpose() * ws_Bv;
+                ws_Vf[0] = v1f;
+                fac_f.noalias() -= fac_V.leftCols(ncols) * ws_Vf.head(ncols);
+                stats_rec.reorth_hit();
+            }
+        }
+        stats_rec.add_reorth_time(StatsPolicy::wall_time() - t_re);
+    }
+
+    // Implicitly restarted Lanczos factorization
+    void restart(int k)
+    {
+        if(k >= ncv)
+            return;
+
+        ws_Q.setIdentity();
+
+        double t_rs = StatsPolicy::wall_time();
+
+        // The shifts and the QR sweeps act on the real tridiagonal H,
+        // exactly as in SymEigsSolver; an orthogonal Q applied to a
+        // B-orthonormal basis keeps it B-orthonormal. All the shifts of
+        // the sweep are fused into one pass over the accumulator
+        ws_decomp.sweep_shifts(fac_H, ritz_val.segment(k, ncv - k), ws_Q);
+        // V -> VQ, only need to update the first k+1 columns
+        ws_Vs.leftCols(k + 1).noalias() = fac_V * ws_Q.leftCols(k + 1);
+        fac_V.leftCols(k + 1).noalias() = ws_Vs.leftCols(k + 1);
+
+        stats_rec.restart_hit();
+        stats_rec.add_restart_time(StatsPolicy::wall_time() - t_rs);
+
+        ws_fk.noalias() = fac_f * ws_Q(ncv - 1, k - 1) + fac_V.col(k) * fac_H(k, k - 1);
+        factorize_from(k, ncv, ws_fk);
+        // Full Ritz vectors are not needed inside the iterations
+        retrieve_ritzpair(false);
+    }
+
+    // Calculate the number of converged Ritz values
+    int num_converged(Scalar tol)
+    {
+        // thresh = tol * max(prec, abs(theta)), theta for ritz value
+        Array thresh = tol * ritz_val.head(nev).array().abs().max(prec);
+        Array resid = ritz_est.head(nev).array().abs() * b_norm(fac_f);
+        // Converged "wanted" ritz values
+        ritz_conv = (resid < thresh);
+
+        return ritz_conv.cast<int>().sum();
+    }
+
+    // Return the adjusted nev for restarting
+    int nev_adjusted(int nconv)
+    {
+        int nev_new = nev;
+
+        // Adjust nev_new, according to dsaup2.f line 677~684 in ARPACK
+        nev_new = nev + std::min(nconv, (ncv - nev) / 2);
+        if(nev == 1 && ncv >= 6)
+            nev_new = ncv / 2;
+        else if(nev == 1 && ncv > 2)
+            nev_new = 2;
+
+        return nev_new;
+    }
+
+    // Retrieve and sort ritz values and ritz vectors
+    // When compute_vecs is false, only the Ritz values and the residual
+    // estimates in ritz_est are updated, which avoids the O(ncv^3)
+    // eigenvector accumulation on every restart
+    void retrieve_ritzpair(bool compute_vecs = true)
+    {
+        double t_rz = StatsPolicy::wall_time();
+        // The decomposition object, the sorting machinery and the index
+        // vectors are all preallocated members, so this routine performs
+        // no memory allocation during the restart iterations
+        ws_eig.compute(fac_H, compute_vecs);
+        const Vector &evals = ws_eig.eigenvalues();
+        const Vector &brow = ws_eig.eigenvectors_bottom_row();
+
+        ws_sort.compute(evals.data(), ncv);
+        int *ind = &ws_ind[0];
+
+        // For BOTH_ENDS, the eigenvalues are sorted according
+        // to the LARGEST_ALGE rule, so we need to move those smallest
+        // values to the left
+        // The order would be
+        // Largest => Smallest => 2nd largest => 2nd smallest => ...
+        // We keep this order since the first k values will always be
+        // the wanted collection, no matter k is nev_updated (used in restart())
+        // or is nev (used in sort_ritzpair())
+        if(SelectionRule == BOTH_ENDS)
+        {
+            ws_sort.index(&ws_ind2[0]);
+            for(int i = 0; i < ncv; i++)
+            {
+                // If i is even, pick values from the left (large values)
+                // If i is odd, pick values from the right (small values)
+                if(i % 2 == 0)
+                    ind[i] = ws_ind2[i / 2];
+                else
+                    ind[i] = ws_ind2[ncv - 1 - i / 2];
+            }
+        } else {
+            ws_sort.index(ind);
+        }
+
+        // Copy the ritz values and vectors to ritz_val and ritz_vec, respectively
+        for(int i = 0; i < ncv; i++)
+        {
+            ritz_val[i] = evals[ind[i]];
+            ritz_est[i] = brow[ind[i]];
+        }
+        if(compute_vecs)
+        {
+            const Matrix &evecs = ws_eig.eigenvectors();
+            for(int i = 0; i < nev; i++)
+            {
+                ritz_vec.col(i) = evecs.col(ind[i]);
+            }
+        }
+
+        stats_rec.add_ritz_time(StatsPolicy::wall_time() - t_rz);
+    }
+
+protected:
+    // Sort the first nev Ritz pairs in decreasing magnitude order
+    // This is used to return the final results
+    virtual void sort_ritzpair()
+    {
+        SortEigenvalue<Scalar, LARGEST_ALGE> sorting(ritz_val.data(), nev);
+        sorting.index(&ws_ind[0]);
+
+        // Apply the permutation in place by following its cycles, so that
+        // no new containers need to be allocated. ws_Vf serves as the
+        // temporary for the eigenvector column being moved.
+        for(int i = 0; i < nev; i++)
+        {
+            if(ws_ind[i] == i)
+                continue;
+
+            Scalar val = ritz_val[i];
+            bool conv = ritz_conv[i];
+            ws_Vf.noalias() = ritz_vec.col(i);
+            int j = i;
+            for(;;)
+            {
+                const int k = ws_ind[j];
+                ws_ind[j] = j;
+                if(k == i)
+                    break;
+                ritz_val[j] = ritz_val[k];
+                ritz_conv[j] = ritz_conv[k];
+                ritz_vec.col(j) = ritz_vec.col(k);
+                j = k;
+            }
+            ritz_val[j] = val;
+            ritz_conv[j] = conv;
+            ritz_vec.col(j) = ws_Vf;
+        }
+    }
+
+public:
+    ///
+    /// Constructor to create a solver object.
+    ///
+    /// \param op_  Pointer to the matrix operation object, which should
+    ///             implement the \f$B^{-1}A\f$ product in perform_op() and
+    ///             the \f$B\f$ product in perform_B_op(). Users could either
+    ///             create the object from the SparseSymGenRegInvSolve wrapper
+    ///             class, or define their own.
+    /// \param nev_ Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-1\f$,
+    ///             where \f$n\f$ is the size of matrix.
+    /// \param ncv_ Parameter that controls the convergence speed of the algorithm.
+    ///             Typically a larger `ncv_` means faster convergence, but it may
+    ///             also result in greater memory use and more matrix operations
+    ///             in each iteration. This parameter must satisfy \f$nev < ncv \le n\f$,
+    ///             and is advised to take \f$ncv \ge 2\cdot nev\f$.
+    ///
+    SymGEigsSolver(OpType *op_, int nev_, int ncv_) :
+        op(op_),
+        dim_n(op->rows()),
+        nev(nev_),
+        ncv(ncv_ > dim_n ? dim_n : ncv_),
+        nmatop(0),
+        niter(0),
+        prec(std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3)),
+        reorth_rule(REORTH_STANDARD)
+    {
+        if(nev_ < 1 || nev_ > dim_n - 1)
+            throw std::invalid_argument("nev must satisfy 1 <= nev <= n - 1, n is the size of matrix");
+
+        if(ncv_ <= nev_ || ncv_ > dim_n)
+            throw std::invalid_argument("ncv must satisfy nev < ncv <= n, n is the size of matrix");
+    }
+
+    ///
+    /// Providing the initial residual vector for the algorithm.
+    ///
+    /// \param init_resid Pointer to the initial residual vector.
+    ///
+    /// **ARPACK-Eigen** (and also **ARPACK**) uses an iterative algorithm
+    /// to find eigenvalues. This function allows the user to provide the initial
+    /// residual vector.
+    ///
+    void init(const Scalar *init_resid)
+    {
+        // Reset all matrices/vectors to zero
+        fac_V.resize(dim_n, ncv);
+        fac_H.resize(ncv, ncv);
+        fac_f.resize(dim_n);
+        ritz_val.resize(ncv);
+        ritz_vec.resize(ncv, nev);
+        ritz_est.resize(ncv);
+        ritz_conv.resize(nev);
+
+        // Allocate the workspace here, so that the iterations
+        // can run without any memory allocation
+        ws_w.resize(dim_n);
+        ws_Bv.resize(dim_n);
+        ws_Vf.resize(ncv);
+        ws_fk.resize(dim_n);
+        ws_Q.resize(ncv, ncv);
+        ws_Vs.resize(dim_n, ncv);
+        ws_ind.resize(ncv);
+        ws_ind2.resize(ncv);
+
+        fac_V.setZero();
+        fac_H.setZero();
+        fac_f.setZero();
+        ritz_val.setZero();
+        ritz_vec.setZero();
+        ritz_est.setZero();
+        ritz_conv.setZero();
+
+        nmatop = 0;
+        niter = 0;
+        stats_rec.reset();
+
+        Vector v(dim_n);
+        std::copy(init_resid, init_resid + dim_n, v.data());
+        Scalar vnorm = b_norm(v);
+        if(vnorm < prec)
+            throw std::invalid_argument("initial residual vector cannot be zero");
+        v /= vnorm;
+
+        double t_op = StatsPolicy::wall_time();
+        op->perform_op(v.data(), ws_w.data());
+        nmatop++;
+        stats_rec.add_op_time(StatsPolicy::wall_time() - t_op);
+
+        op->perform_B_op(ws_w.data(), ws_Bv.data());
+        fac_H(0, 0) = v.dot(ws_Bv);
+        fac_f = ws_w - v * fac_H(0, 0);
+        fac_V.col(0) = v;
+    }
+
+    ///
+    /// Providing a random initial residual vector.
+    ///
+    /// This overloaded function generates a random initial residual vector
+    /// for the algorithm. Elements in the vector follow independent Uniform(-0.5, 0.5)
+    /// distributions.
+    ///
+    void init()
+    {
+        Vector init_resid = Vector::Random(dim_n);
+        init_resid.array() -= 0.5;
+        init(init_resid.data());
+    }
+
+    ///
+    /// Conducting the major computation procedure.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        // The m-step Lanczos factorization
+        // ws_fk is used here since factorize_from() overwrites fac_f
+        ws_fk = fac_f;
+        factorize_from(1, ncv, ws_fk);
+        niter++;
+
+        return compute_continue(maxit, tol);
+    }
+
+    ///
+    /// Resuming the computation from the current Lanczos factorization,
+    /// without rebuilding it from the initial residual vector. It can be
+    /// called after compute() has exhausted its iteration allowance, and
+    /// all the progress made before is kept.
+    ///
+    /// \param maxit Maximum number of iterations allowed in the algorithm.
+    /// \param tol Precision parameter for the calculated eigenvalues.
+    ///
+    /// \return Number of converged eigenvalues.
+    ///
+    int compute_continue(int maxit = 1000, Scalar tol = 1e-10)
+    {
+        retrieve_ritzpair(false);
+        // Restarting
+        int i, nconv = 0, nev_adj;
+        for(i = 0; i < maxit; i++)
+        {
+            nconv = num_converged(tol);
+            // The residual norms below are only computed when a recording
+            // statistics policy is in use
+            if(StatsPolicy::enabled)
+                stats_rec.iteration(niter + i, nconv,
+                    (ritz_est.head(nev).array().abs() * b_norm(fac_f)).maxCoeff());
+            if(nconv >= nev)
+                break;
+
+            nev_adj = nev_adjusted(nconv);
+            restart(nev_adj);
+        }
+        // The iterations above only work with Ritz values and residual
+        // estimates; compute the full Ritz vectors once at the end
+        retrieve_ritzpair(true);
+        nconv = num_converged(tol);
+        // Sorting results
+        sort_ritzpair();
+
+        niter += i;
+
+        return std::min(nev, nconv);
+    }
+
+    ///
+    /// Returning the number of iterations used in the computation.
+    ///
+    int num_iterations() { return niter; }
+
+    ///
+    /// Returning the number of matrix operations used in the computation.
+    /// The \f$B\f$ products of the inner products are not counted here,
+    /// only the applications of the (inverted) operator itself.
+    ///
+    int num_operations() { return nmatop; }
+
+    ///
+    /// Returning the statistics object of the solver. For the default
+    /// NullSolverStats policy this object records nothing; instantiate the
+    /// solver with SolverStats as the `StatsPolicy` template parameter to
+    /// obtain per-phase wall times, reorthogonalization and restart counts,
+    /// and the per-iteration residual norms. The reference is mutable so
+    /// that a per-iteration callback can be installed before compute().
+    ///
+    StatsPolicy & stats() { return stats_rec; }
+
+    ///
+    /// Selecting the reorthogonalization strategy used in the Lanczos
+    /// factorization. The full list of enumeration values can be found in
+    /// ReorthRule.h . The default REORTH_STANDARD keeps the behavior of
+    /// the other solvers; REORTH_DGKS is recommended for ill-conditioned
+    /// operators.
+    ///
+    /// \param rule One of the `REORTH_*` enumeration values.
+    ///
+    void set_reorth_rule(int rule) { reorth_rule = rule; }
+
+    ///
+    /// Returning the converged eigenvalues.
+    ///
+    /// \return A vector containing the eigenvalues.
+    /// Returned vector type will be `Eigen::Vector<Scalar, ...>`, depending on
+    /// the template parameter `Scalar` defined.
+    ///
+    Vector eigenvalues()
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        Vector res(nconv);
+
+        if(nconv)
+            eigenvalues(res.data());
+
+        return res;
+    }
+
+    ///
+    /// Writing the converged eigenvalues directly into a caller-supplied
+    /// buffer, avoiding the allocation of the returned vector.
+    ///
+    /// \param dest Pointer to a buffer of at least num_converged_eigenvalues()
+    ///             scalars.
+    ///
+    void eigenvalues(Scalar *dest)
+    {
+        int j = 0;
+        for(int i = 0; i < nev; i++)
+        {
+            if(ritz_conv[i])
+            {
+                dest[j] = ritz_val[i];
+                j++;
+            }
+        }
+    }
+
+    ///
+    /// Returning the number of converged eigenvalues, i.e. the number of
+    /// values written by eigenvalues(Scalar *) and the maximum number of
+    /// columns written by eigenvectors(Scalar *, int).
+    ///
+    int num_converged_eigenvalues() { return ritz_conv.cast<int>().sum(); }
+
+    ///
+    /// Returning the eigenvectors associated with the converged
+    /// eigenvalues. The columns are \f$B\f$-orthonormal, i.e.
+    /// \f$V'BV=I\f$.
+    ///
+    /// \param nvec The number of eigenvectors to return.
+    ///
+    /// \return A matrix containing the eigenvectors.
+    /// Returned matrix type will be `Eigen::Matrix<Scalar, ...>`,
+    /// depending on the template parameter `Scalar` defined.
+    ///
+    Matrix eigenvectors(int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
+        Matrix res(dim_n, nvec);
+
+        if(nvec)
+            eigenvectors(res.data(), nvec);
+
+        return res;
+    }
+
+    ///
+    /// Returning all converged eigenvectors.
+    ///
+    Matrix eigenvectors()
+    {
+        return eigenvectors(nev);
+    }
+
+    ///
+    /// Writing the converged eigenvectors directly into a caller-supplied
+    /// buffer, so that no \f$n\times nvec\f$ matrix is allocated or copied.
+    ///
+    /// \param dest Pointer to a buffer of at least \f$n\times nvec\f$
+    ///             scalars, which will be filled in column-major order.
+    /// \param nvec The number of eigenvectors to write. It is capped by the
+    ///             number of converged eigenvalues.
+    ///
+    void eigenvectors(Scalar *dest, int nvec)
+    {
+        int nconv = ritz_conv.cast<int>().sum();
+        nvec = std::min(nvec, nconv);
+        if(!nvec)
+            return;
+
+        Matrix ritz_vec_conv(ncv, nvec);
+        int j = 0;
+        for(int i = 0; i < nev && j < nvec; i++)
+        {
+            if(ritz_conv[i])
+            {
+                ritz_vec_conv.col(j) = ritz_vec.col(i);
+                j++;
+            }
+        }
+
+        MapMat res(dest, dim_n, nvec);
+        res.noalias() = fac_V * ritz_vec_conv;
+    }
+};
+
+
+
+
+///
+/// \ingroup EigenSolver
+///
+/// This class implements the eigen solver for the generalized eigen
+/// problem \f$Ax=\lambda Bx\f$ in the **shift-invert mode** (mode 3 of
+/// **ARPACK**). The solver works on the operator
+/// \f$(A-\sigma B)^{-1}B\f$, whose eigenvalues are
+/// \f$\nu=1/(\lambda-\sigma)\f$, using the same \f$B\f$-inner-product
+/// Lanczos recurrence as SymGEigsSolver; the eigenvalues() method
+/// transforms the results back and always reports \f$\lambda\f$. A
+/// selection rule of `LARGEST_MAGN` therefore finds the generalized
+/// eigenvalues closest to \f$\sigma\f$, which is the standard way of
+/// computing the smallest eigenvalues of a stiffness/mass pencil by
+/// setting \f$\sigma=0\f$ (or a small negative value).
+///
+/// \tparam Scalar        The element type of the matrix.
+///                       Currently supported types are `float`, `double` and `long double`.
+/// \tparam SelectionRule An enumeration value indicating the selection rule of
+///                       the shifted-and-inverted eigenvalues.
+///                       The full list of enumeration values can be found in
+///                       SelectionRule.h .
+/// \tparam OpType        The name of the matrix operation class. Users could
+///                       either use the SparseSymGenShiftSolve wrapper class,
+///                       or define their own that impelemnts the
+///                       \f$(A-\sigma B)^{-1}B\f$ product in perform_op(),
+///                       the \f$B\f$ product in perform_B_op(), and
+///                       set_shift().
+///
+template <typename Scalar = double,
+          int SelectionRule = LARGEST_MAGN,
+          typename OpType = SparseSymGenShiftSolve<double>,
+          typename StatsPolicy = NullSolverStats<Scalar> >
+class SymGEigsShiftSolver: public SymGEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy>
+{
+private:
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
+
+    Scalar sigma;
+
+    // First transform back the ritz values, and then sort
+    void sort_ritzpair()
+    {
+        Array ritz_val_org = Scalar(1.0) / this->ritz_val.head(this->nev).array() + sigma;
+        this->ritz_val.head(this->nev) = ritz_val_org;
+        SymGEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy>::sort_ritzpair();
+    }
+public:
+    ///
+    /// Constructor to create a eigen solver object using the shift-invert mode.
+    ///
+    /// \param op_    Pointer to the matrix operation object, which should
+    ///               implement the \f$(A-\sigma B)^{-1}B\f$ product, the
+    ///               \f$B\f$ product and set_shift(). Users could either
+    ///               create the object from the SparseSymGenShiftSolve
+    ///               wrapper class, or define their own.
+    /// \param nev_   Number of eigenvalues requested. This should satisfy \f$1\le nev \le n-1\f$,
+    ///               where \f$n\f$ is the size of matrix.
+    /// \param ncv_   Parameter that controls the convergence speed of the algorithm.
+    ///               Typically a larger `ncv_` means faster convergence, but it may
+    ///               also result in greater memory use and more matrix operations
+    ///               in each iteration. This parameter must satisfy \f$nev < ncv \le n\f$,
+    ///               and is advised to take \f$ncv \ge 2\cdot nev\f$.
+    /// \param sigma_ The value of the shift.
+    ///
+    SymGEigsShiftSolver(OpType *op_, int nev_, int ncv_, Scalar sigma_) :
+        SymGEigsSolver<Scalar, SelectionRule, OpType, StatsPolicy>(op_, nev_, ncv_),
+        sigma(sigma_)
+    {
+        this->op->set_shift(sigma);
+    }
+};
+
+#endif // SYM_GEIGS_SOLVER_H
@@ -15,7 +15,13 @@
 #include <Eigen/Eigenvalues>
 #include <stdexcept>
 
-template <typename Scalar = double>
+// The optional MaxNcv template parameter puts a compile-time bound on the
+// matrix size: with a finite bound all the internal storage becomes
+// fixed-capacity (allocated inline in the object), so the per-compute()
+// resizes never touch the heap. The solvers thread their own MaxNcv
+// parameter down here, which pays off in streaming workloads that solve
+// many problems with a small constant ncv.
+template <typename Scalar = double, int MaxNcv = Eigen::Dynamic>
 class TridiagEigen
 {
 private:
@@ -25,34 +31,114 @@ private:
     typedef Eigen::Ref<Matrix> GenericMatrix;
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
 
+    // Fixed-capacity storage types, identical to the dynamic ones when
+    // MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxNcv, MaxNcv> StorageMatrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> StorageVector;
+
     int n;
-    Vector main_diag;     // Main diagonal elements of the matrix
-    Vector sub_diag;      // Sub-diagonal elements of the matrix
-    Matrix evecs;         // To store eigenvectors
+    StorageVector main_diag;  // Main diagonal elements of the matrix
+    StorageVector sub_diag;   // Sub-diagonal elements of the matrix
+    StorageMatrix evecs;      // To store eigenvectors
+    StorageVector evecs_row;  // Last row of the eigenvector matrix, for the
+                              // values-only mode
 
     bool computed;
+    bool vecs_computed;   // Whether the full eigenvectors were computed
+
+    // The same iteration as Eigen::internal::tridiagonal_qr_step, except
+    // that the Givens rotations are accumulated only into a single row
+    // vector instead of the full eigenvector matrix. This is all that
+    // num_converged() in the solvers needs, and it turns the O(n^3)
+    // rotation accumulation into O(n^2).
+    static void qr_step_with_row(Scalar *diag, Scalar *subdiag, int start, int end, Scalar *row)
+    {
+        // Wilkinson shift
+        Scalar td = (diag[end - 1] - diag[end]) * Scalar(0.5);
+        Scalar e = subdiag[end - 1];
+        Scalar mu = diag[end];
+        if(td == Scalar(0))
+            mu -= std::abs(e);
+        else
+        {
+            Scalar e2 = e * e;
+            Scalar h = Eigen::numext::hypot(td, e);
+            if(e2 == Scalar(0))
+                mu -= (e / (td + (td > Scalar(0) ? Scalar(1) : Scalar(-1)))) * (e / h);
+            else
+                mu -= e2 / (td + (td > Scalar(0) ? h : -h));
+        }
+
+        Scalar x = diag[start] - mu;
+        Scalar z = subdiag[start];
+        for(int k = start; k < end; k++)
+        {
+            Eigen::JacobiRotation<Scalar> rot;
+            rot.makeGivens(x, z);
+            const Scalar c = rot.c();
+            const Scalar s = rot.s();
+
+            // T = G' T G
+            Scalar sdk = s * diag[k] + c * subdiag[k];
+            Scalar dkp1 = s * subdiag[k] + c * diag[k + 1];
+
+            diag[k] = c * (c * diag[k] - s * subdiag[k]) - s * (c * subdiag[k] - s * diag[k + 1]);
+            diag[k + 1] = s * sdk + c * dkp1;
+            subdiag[k] = c * sdk - s * dkp1;
+
+            if(k > start)
+                subdiag[k - 1] = c * subdiag[k - 1] - s * z;
+
+            x = subdiag[k];
+
+            if(k < end - 1)
+            {
+                z = -s * subdiag[k + 1];
+                subdiag[k + 1] = c * subdiag[k + 1];
+            }
+
+            // row = row * G, the same update that applyOnTheRight()
+            // performs on every row of the full eigenvector matrix
+            Scalar r0 = row[k], r1 = row[k + 1];
+            row[k] = c * r0 - s * r1;
+            row[k + 1] = s * r0 + c * r1;
+        }
+    }
 
 public:
     TridiagEigen() :
-        n(0), computed(false)
+        n(0), computed(false), vecs_computed(false)
     {}
 
     TridiagEigen(ConstGenericMatrix &mat) :
-        n(mat.rows()), computed(false)
+        n(mat.rows()), computed(false), vecs_computed(false)
     {
         compute(mat);
     }
 
-    void compute(ConstGenericMatrix &mat)
+    // When compute_evecs is false, only the eigenvalues and the last row
+    // of the eigenvector matrix are computed, which is much cheaper and
+    // is all that the solvers need during the restart iterations
+    void compute(ConstGenericMatrix &mat, bool compute_evecs = true)
     {
         if(mat.rows() != mat.cols())
             throw std::invalid_argument("TridiagEigen: matrix must be square");
+        if(MaxNcv != Eigen::Dynamic && mat.rows() > MaxNcv)
+            throw std::invalid_argument("TridiagEigen: matrix size exceeds the MaxNcv template parameter");
 
         n = mat.rows();
         main_diag = mat.diagonal();
         sub_diag = mat.diagonal(-1);
-        evecs.resize(n, n);
-        evecs.setIdentity();
+        vecs_computed = compute_evecs;
+        if(compute_evecs)
+        {
+            evecs.resize(n, n);
+            evecs.setIdentity();
+        } else {
+            evecs_row.resize(n);
+            evecs_row.setZero();
+            evecs_row[n - 1] = 1;
+        }
 
         int end = n - 1;
         int start = 0;
@@ -87,7 +173,10 @@ public:
             while(start > 0 && subd[start - 1] != 0)
                 start--;
 
-            Eigen::internal::tridiagonal_qr_step<Eigen::ColMajor>(maind, subd, start, end, evecs.data(), n);
+            if(vecs_computed)
+                Eigen::internal::tridiagonal_qr_step<Eigen::ColMajor>(maind, subd, start, end, evecs.data(), n);
+            else
+                qr_step_with_row(maind, subd, start, end, evecs_row.data());
         }
 
         if(info > 0)
@@ -96,7 +185,10 @@ public:
         computed = true;
     }
 
-    Vector eigenvalues()
+    // The accessors below return references to internal storage, so that
+    // callers holding a TridiagEigen object across iterations can read
+    // the results without copying them
+    const StorageVector & eigenvalues()
     {
         if(!computed)
             throw std::logic_error("TridiagEigen: need to call compute() first");
@@ -105,13 +197,27 @@ public:
         return main_diag;
     }
 
-    Matrix eigenvectors()
+    const StorageMatrix & eigenvectors()
     {
         if(!computed)
             throw std::logic_error("TridiagEigen: need to call compute() first");
+        if(!vecs_computed)
+            throw std::logic_error("TridiagEigen: eigenvectors were not computed");
 
         return evecs;
     }
+
+    // Last row of the eigenvector matrix, available in both modes
+    const StorageVector & eigenvectors_bottom_row()
+    {
+        if(!computed)
+            throw std::logic_error("TridiagEigen: need to call compute() first");
+
+        if(vecs_computed)
+            evecs_row = evecs.row(n - 1).transpose();
+
+        return evecs_row;
+    }
 };
 
 
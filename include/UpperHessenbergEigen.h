@@ -15,7 +15,11 @@
 #include <Eigen/Eigenvalues>
 #include <stdexcept>
 
-template <typename Scalar = double>
+// The optional MaxNcv template parameter puts a compile-time bound on the
+// matrix size, turning the internal storage (including the RealSchur
+// workspace) into fixed-capacity objects whose per-compute() resizes
+// never touch the heap; see UpperHessenbergQR
+template <typename Scalar = double, int MaxNcv = Eigen::Dynamic>
 class UpperHessenbergEigen
 {
 private:
@@ -29,13 +33,23 @@ private:
     typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic> ComplexMatrix;
     typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1> ComplexVector;
 
+    // Fixed-capacity storage types, identical to the dynamic ones when
+    // MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxNcv, MaxNcv> StorageMatrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> StorageVector;
+    typedef Eigen::Matrix<Complex, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> ComplexStorageVector;
+
     int dim_n;                             // Size of the matrix
-    Eigen::RealSchur<Matrix> m_realSchur;  // Schur decomposition solver
-    Matrix m_matT;                         // Schur T matrix
-    Matrix m_eivec;                        // Storing eigenvectors
-    ComplexVector m_eivalues;              // Eigenvalues
+    Eigen::RealSchur<StorageMatrix> m_realSchur;  // Schur decomposition solver
+    StorageMatrix m_matT;                  // Schur T matrix
+    StorageMatrix m_eivec;                 // Storing eigenvectors
+    ComplexStorageVector m_eivalues;       // Eigenvalues
+    ComplexStorageVector m_brow;           // Last row of the eigenvector
+                                           // matrix, filled on demand
 
     bool computed;
+    bool vecs_computed;                    // Whether the back transformation
+                                           // to full eigenvectors was done
 
     // Complex scalar division
     static Complex cdiv(const Scalar& xr, const Scalar& xi, const Scalar& yr, const Scalar& yi)
@@ -53,7 +67,12 @@ private:
         }
     }
 
-    void doComputeEigenvectors()
+    // Backsubstitution, storing the eigenvectors of the Schur matrix T in
+    // the columns of m_matT. The O(n^3) back transformation V = U * X is
+    // only performed when full eigenvectors are requested; the values-only
+    // mode stops after this function and reads the last row of the
+    // eigenvectors directly from U and X.
+    void doComputeEigenvectors(bool transform)
     {
         const int size = m_eivec.cols();
         const Scalar eps = std::numeric_limits<Scalar>::epsilon();
@@ -196,8 +215,11 @@ private:
             }
         }
 
+        if(!transform)
+            return;
+
         // Back transformation to get eigenvectors of original matrix
-        Vector m_tmp(size);
+        StorageVector m_tmp(size);
         for(int j = size-1; j >= 0; j--)
         {
             m_tmp.noalias() = m_eivec.leftCols(j+1) * m_matT.col(j).segment(0, j+1);
@@ -208,24 +230,30 @@ private:
 public:
 
     UpperHessenbergEigen() :
-        dim_n(0), computed(false)
+        dim_n(0), computed(false), vecs_computed(false)
     {}
 
     UpperHessenbergEigen(ConstGenericMatrix &mat) :
-        dim_n(mat.rows()), computed(false)
+        dim_n(mat.rows()), computed(false), vecs_computed(false)
     {
         compute(mat);
     }
 
-    void compute(ConstGenericMatrix &mat)
+    // When compute_evecs is false, only the eigenvalues and the last row
+    // of the eigenvector matrix are computed, which skips the O(n^3)
+    // back transformation and is all that the solvers need during the
+    // restart iterations
+    void compute(ConstGenericMatrix &mat, bool compute_evecs = true)
     {
         if(mat.rows() != mat.cols())
             throw std::invalid_argument("UpperHessenbergEigen: matrix must be square");
+        if(MaxNcv != Eigen::Dynamic && mat.rows() > MaxNcv)
+            throw std::invalid_argument("UpperHessenbergEigen: matrix size exceeds the MaxNcv template parameter");
 
         dim_n = mat.rows();
 
         // Reduce to real Schur form
-        Matrix Q = Matrix::Identity(dim_n, dim_n);
+        StorageMatrix Q = StorageMatrix::Identity(dim_n, dim_n);
         m_realSchur.computeFromHessenberg(mat, Q, true);
         m_matT = m_realSchur.matrixT();
         m_eivec = m_realSchur.matrixU();
@@ -252,12 +280,16 @@ public:
         }
 
         // Compute eigenvectors
-        doComputeEigenvectors();
+        vecs_computed = compute_evecs;
+        doComputeEigenvectors(compute_evecs);
 
         computed = true;
     }
 
-    ComplexVector eigenvalues()
+    // A reference to internal storage is returned, so that callers holding
+    // an UpperHessenbergEigen object across iterations can read the
+    // eigenvalues without copying them
+    const ComplexStorageVector & eigenvalues()
     {
         if(!computed)
             throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
@@ -269,6 +301,8 @@ public:
     {
         if(!computed)
             throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
+        if(!vecs_computed)
+            throw std::logic_error("UpperHessenbergEigen: eigenvectors were not computed");
 
         int n = m_eivec.cols();
         const Scalar prec = std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3);
@@ -296,6 +330,56 @@ public:
 
         return matV;
     }
+
+    // Last row of the (normalized) eigenvector matrix, available in both
+    // modes. In the values-only mode it is assembled from the last row of
+    // the Schur basis U and the triangular eigenvectors X, using the fact
+    // that the column norms of V = U * X equal those of X since U is
+    // orthogonal.
+    const ComplexStorageVector & eigenvectors_bottom_row()
+    {
+        if(!computed)
+            throw std::logic_error("UpperHessenbergEigen: need to call compute() first");
+
+        const int n = dim_n;
+        const Scalar prec = std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2.0) / 3);
+        m_brow.resize(n);
+        Complex *br = m_brow.data();
+
+        for(int j = 0; j < n; ++j)
+        {
+            if(std::abs(m_eivalues.coeff(j).imag()) <= prec || j + 1 == n)
+            {
+                // Real eigenvalue
+                if(vecs_computed)
+                {
+                    br[j] = Complex(m_eivec.coeff(n - 1, j) / m_eivec.col(j).norm(), 0);
+                } else {
+                    Scalar v = m_eivec.row(n - 1).head(j + 1).dot(m_matT.col(j).head(j + 1));
+                    br[j] = Complex(v / m_matT.col(j).head(j + 1).norm(), 0);
+                }
+            } else {
+                // Complex conjugate pair
+                Scalar vr, vi, nrm;
+                if(vecs_computed)
+                {
+                    vr = m_eivec.coeff(n - 1, j);
+                    vi = m_eivec.coeff(n - 1, j + 1);
+                    nrm = std::sqrt(m_eivec.col(j).squaredNorm() + m_eivec.col(j + 1).squaredNorm());
+                } else {
+                    const int len = std::min(j + 2, n);
+                    vr = m_eivec.row(n - 1).head(len).dot(m_matT.col(j).head(len));
+                    vi = m_eivec.row(n - 1).head(len).dot(m_matT.col(j + 1).head(len));
+                    nrm = std::sqrt(m_matT.col(j).head(len).squaredNorm() + m_matT.col(j + 1).head(len).squaredNorm());
+                }
+                br[j] = Complex(vr, vi) / nrm;
+                br[j + 1] = Complex(vr, -vi) / nrm;
+                ++j;
+            }
+        }
+
+        return m_brow;
+    }
 };
 
 
@@ -25,8 +25,12 @@
 ///
 /// \tparam Scalar The element type of the matrix.
 /// Currently supported types are `float`, `double` and `long double`.
+/// \tparam MaxNcv Optional compile-time bound on the matrix size. With a
+/// finite bound the internal storage becomes fixed-capacity (allocated
+/// inline in the object), so the per-compute() resizes never touch the
+/// heap. Matrices larger than the bound are rejected.
 ///
-template <typename Scalar = double>
+template <typename Scalar = double, int MaxNcv = Eigen::Dynamic>
 class UpperHessenbergQR
 {
 private:
@@ -34,20 +38,30 @@ private:
     typedef Eigen::Matrix<Scalar, 2, 2> Matrix22;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
     typedef Eigen::Matrix<Scalar, 1, Eigen::Dynamic> RowVector;
-    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> Array;
 
     typedef Eigen::Ref<Matrix> GenericMatrix;
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
+    typedef const Eigen::Ref<const Vector> ConstGenericVector;
+
+    // Fixed-capacity storage types, identical to the dynamic ones when
+    // MaxNcv is Eigen::Dynamic
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxNcv, MaxNcv> StorageMatrix;
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, MaxNcv, 1> StorageArray;
 
 protected:
     int n;
-    Matrix mat_T;
+    StorageMatrix mat_T;
     // Gi = [ cos[i]  sin[i]]
     //      [-sin[i]  cos[i]]
     // Q = G1 * G2 * ... * G_{n-1}
-    Array rot_cos;
-    Array rot_sin;
+    StorageArray rot_cos;
+    StorageArray rot_sin;
     bool computed;
+    // Rotations of all shifts of a sweep_shifts() call, one column per
+    // shift, kept so that they can be replayed on the accumulator in a
+    // single blocked pass
+    StorageMatrix sweep_cos;
+    StorageMatrix sweep_sin;
 public:
     ///
     /// Default constructor. Computation can
@@ -88,6 +102,9 @@ public:
     ///
     virtual void compute(ConstGenericMatrix &mat)
     {
+        if(MaxNcv != Eigen::Dynamic && mat.rows() > MaxNcv)
+            throw std::invalid_argument("UpperHessenbergQR: matrix size exceeds the MaxNcv template parameter");
+
         n = mat.rows();
         mat_T.resize(n, n);
         rot_cos.resize(n - 1);
@@ -167,13 +184,29 @@ public:
     /// the template parameter `Scalar` defined.
     ///
     virtual Matrix matrix_RQ()
+    {
+        Matrix RQ(n, n);
+        matrix_RQ(RQ);
+        return RQ;
+    }
+
+    ///
+    /// Overwrite `RQ` with the \f$RQ\f$ matrix. This overload writes into
+    /// an existing matrix of the proper size, so repeated calls do not
+    /// allocate memory.
+    ///
+    /// \param RQ A matrix of size `n x n` that will be overwritten by \f$RQ\f$.
+    ///
+    virtual void matrix_RQ(GenericMatrix RQ)
     {
         if(!computed)
             throw std::logic_error("UpperHessenbergQR: need to call compute() first");
 
         // Make a copy of the R matrix
-        Matrix RQ = mat_T.template triangularView<Eigen::Upper>();
+        RQ.setZero();
+        RQ.template triangularView<Eigen::Upper>() = mat_T;
 
+        const int stride = RQ.outerStride();
         Scalar *c = rot_cos.data(),
                *s = rot_sin.data();
         for(int i = 0; i < n - 1; i++)
@@ -184,7 +217,7 @@ public:
 
             Scalar *Yi, *Yi1;
             Yi = &RQ(0, i);
-            Yi1 = Yi + n;  // RQ(0, i + 1)
+            Yi1 = Yi + stride;  // RQ(0, i + 1)
             for(int j = 0; j < i + 2; j++)
             {
                 Scalar tmp = Yi[j];
@@ -198,8 +231,6 @@ public:
             c++;
             s++;
         }
-
-        return RQ;
     }
 
     ///
@@ -394,6 +425,78 @@ public:
             s--;
         }
     }
+
+    ///
+    /// Perform the shifted QR sweeps for a whole vector of shifts in one
+    /// fused operation: for each shift \f$\mu_j\f$ the matrix `H` is
+    /// updated to \f$Q_j'HQ_j\f$ with \f$Q_jR_j=H-\mu_j I\f$, and the
+    /// accumulator `Y` is overwritten by \f$YQ_1Q_2\cdots\f$. The small
+    /// factorizations are still carried out shift by shift, but all the
+    /// Givens rotations are recorded and replayed on `Y` in a single
+    /// row-blocked pass, so each block of `Y` is loaded into cache once
+    /// for the entire sweep instead of once per shift. This is the
+    /// dominant cost of the implicit restarts when the number of shifts
+    /// is large, and it is where the fusion pays off.
+    ///
+    /// \param H      An upper Hessenberg (or tridiagonal, for the TridiagQR
+    ///               specialization) matrix, overwritten by the result of
+    ///               the sweeps. It remains in the same form.
+    /// \param shifts Vector of shifts, applied in order.
+    /// \param Y      The rotation accumulator, overwritten by
+    ///               \f$YQ_1Q_2\cdots\f$. It must have `H.rows()` columns.
+    ///
+    void sweep_shifts(GenericMatrix H, ConstGenericVector &shifts, GenericMatrix Y)
+    {
+        const int m = H.rows();
+        const int nshift = shifts.size();
+        if(nshift < 1)
+            return;
+
+        sweep_cos.resize(m - 1, nshift);
+        sweep_sin.resize(m - 1, nshift);
+
+        // The factorization and the O(n) (tridiagonal) or O(n^2)
+        // (Hessenberg) rebuild of H are cheap; record the rotations of
+        // each shift instead of applying them to Y right away
+        for(int j = 0; j < nshift; j++)
+        {
+            H.diagonal().array() -= shifts[j];
+            this->compute(H);
+            sweep_cos.col(j) = rot_cos.matrix();
+            sweep_sin.col(j) = rot_sin.matrix();
+            // H = QR + mu * I, so Q'HQ = RQ + mu * I
+            this->matrix_RQ(H);
+            H.diagonal().array() += shifts[j];
+        }
+
+        // Replay all the rotations on Y, block of rows by block of rows.
+        // Each rotation touches two adjacent columns, so a row block of Y
+        // stays in cache while the whole rotation sequence of every shift
+        // streams over it
+        const int nrow = Y.rows();
+        const int bsize = 32;
+        for(int r = 0; r < nrow; r += bsize)
+        {
+            const int b = std::min(bsize, nrow - r);
+            for(int j = 0; j < nshift; j++)
+            {
+                const Scalar *c = &sweep_cos(0, j),
+                             *s = &sweep_sin(0, j);
+                for(int i = 0; i < m - 1; i++, c++, s++)
+                {
+                    // Y[r:(r + b - 1), i:(i + 1)] = Y[r:(r + b - 1), i:(i + 1)] * Gi
+                    Scalar *Y_col_i  = &Y(r, i);
+                    Scalar *Y_col_i1 = &Y(r, i + 1);
+                    for(int l = 0; l < b; l++)
+                    {
+                        Scalar tmp = Y_col_i[l];
+                        Y_col_i[l]  = (*c) * tmp - (*s) * Y_col_i1[l];
+                        Y_col_i1[l] = (*s) * tmp + (*c) * Y_col_i1[l];
+                    }
+                }
+            }
+        }
+    }
 };
 
 
@@ -404,12 +507,15 @@ public:
 ///
 /// \tparam Scalar The element type of the matrix.
 /// Currently supported types are `float`, `double` and `long double`.
+/// \tparam MaxNcv Optional compile-time bound on the matrix size, as in
+/// UpperHessenbergQR.
 ///
-template <typename Scalar = double>
-class TridiagQR: public UpperHessenbergQR<Scalar>
+template <typename Scalar = double, int MaxNcv = Eigen::Dynamic>
+class TridiagQR: public UpperHessenbergQR<Scalar, MaxNcv>
 {
 private:
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Ref<Matrix> GenericMatrix;
     typedef const Eigen::Ref<const Matrix> ConstGenericMatrix;
 
 public:
@@ -418,7 +524,7 @@ public:
     /// be performed later by calling the compute() method.
     ///
     TridiagQR() :
-        UpperHessenbergQR<Scalar>()
+        UpperHessenbergQR<Scalar, MaxNcv>()
     {}
 
     ///
@@ -432,7 +538,7 @@ public:
     /// the matrix are used.
     ///
     TridiagQR(ConstGenericMatrix &mat) :
-        UpperHessenbergQR<Scalar>()
+        UpperHessenbergQR<Scalar, MaxNcv>()
     {
         this->compute(mat);
     }
@@ -448,6 +554,9 @@ public:
     ///
     void compute(ConstGenericMatrix &mat)
     {
+        if(MaxNcv != Eigen::Dynamic && mat.rows() > MaxNcv)
+            throw std::invalid_argument("TridiagQR: matrix size exceeds the MaxNcv template parameter");
+
         this->n = mat.rows();
         this->mat_T.resize(this->n, this->n);
         this->rot_cos.resize(this->n - 1);
@@ -545,18 +654,32 @@ public:
     /// the template parameter `Scalar` defined.
     ///
     Matrix matrix_RQ()
+    {
+        Matrix RQ(this->n, this->n);
+        matrix_RQ(RQ);
+        return RQ;
+    }
+
+    ///
+    /// Overwrite `RQ` with the \f$RQ\f$ matrix. This overload writes into
+    /// an existing matrix of the proper size, so repeated calls do not
+    /// allocate memory.
+    ///
+    /// \param RQ A matrix of size `n x n` that will be overwritten by \f$RQ\f$.
+    ///
+    void matrix_RQ(GenericMatrix RQ)
     {
         if(!this->computed)
             throw std::logic_error("TridiagQR: need to call compute() first");
 
         // Make a copy of the R matrix
-        Matrix RQ(this->n, this->n);
         RQ.setZero();
         RQ.diagonal() = this->mat_T.diagonal();
         RQ.diagonal(1) = this->mat_T.diagonal(1);
 
         // [m11  m12] will point to RQ[i:(i+1), i:(i+1)]
         // [m21  m22]
+        const int stride = RQ.outerStride();
         Scalar *m11 = RQ.data(), *m12, *m21, *m22,
                *c = this->rot_cos.data(),
                *s = this->rot_sin.data(),
@@ -564,7 +687,7 @@ public:
         for(int i = 0; i < this->n - 1; i++)
         {
             m21 = m11 + 1;
-            m12 = m11 + this->n;
+            m12 = m11 + stride;
             m22 = m12 + 1;
             tmp = *m21;
 
@@ -581,8 +704,6 @@ public:
 
         // Copy the below-subdiagonal to above-subdiagonal
         RQ.diagonal(1) = RQ.diagonal(-1);
-
-        return RQ;
     }
 };
 
@@ -0,0 +1,149 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::VectorXcd ComplexVector;
+
+// A symmetric matrix with clustered leading eigenvalues, on which a
+// small subspace converges very slowly
+Matrix clustered_sym(int n)
+{
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = 0.01 * (A + A.transpose());
+    for(int i = 0; i < 10; i++)
+        M(i, i) += 10.0 + 0.01 * i;
+    return M;
+}
+
+TEST_CASE("Subspace grows on a hard symmetric problem", "[adaptive_ncv]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = clustered_sym(n);
+
+    Eigen::SelfAdjointEigenSolver<Matrix> es(M);
+    Vector ref = es.eigenvalues().tail(8).reverse();
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 8, 10);
+    eigs.set_ncv_bounds(10, 60, 3);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(500);
+
+    // The stalled restarts must have pushed the subspace up
+    INFO( "final ncv = " << eigs.subspace_size() );
+    REQUIRE( eigs.subspace_size() > 10 );
+    REQUIRE( nconv == 8 );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    REQUIRE( (evals - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+// A diagonal operator with a slowly decaying spectrum: the wanted pairs
+// converge one after another across the restarts
+class SlowDecayDiag
+{
+private:
+    Vector d;
+public:
+    SlowDecayDiag(int n) : d(n)
+    {
+        for(int i = 0; i < n; i++)
+            d[i] = std::pow(10.0, -2.0 * double(n - 1 - i) / double(n - 1));
+    }
+    int rows() { return d.size(); }
+    int cols() { return d.size(); }
+    // y_out = D * x_in
+    void perform_op(double *x_in, double *y_out)
+    {
+        for(int i = 0; i < d.size(); i++)
+            y_out[i] = d[i] * x_in[i];
+    }
+    const Vector & diagonal() { return d; }
+};
+
+TEST_CASE("Subspace shrinks when every restart makes progress", "[adaptive_ncv]")
+{
+    const int n = 2000;
+    SlowDecayDiag op(n);
+    Vector ref = op.diagonal().tail(6).reverse();
+
+    SymEigsSolver<double, LARGEST_MAGN, SlowDecayDiag> eigs(&op, 6, 80);
+    eigs.set_ncv_bounds(13, 80, 1);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(500);
+
+    INFO( "final ncv = " << eigs.subspace_size() );
+    REQUIRE( eigs.subspace_size() < 80 );
+    REQUIRE( nconv == 6 );
+
+    Vector evals = eigs.eigenvalues();
+    REQUIRE( (evals - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Subspace grows in the general solver", "[adaptive_ncv]")
+{
+    srand(123);
+    const int n = 400;
+    Matrix A = Matrix::Random(n, n);
+
+    DenseGenMatProd<double> op(A);
+
+    // Reference result from a fixed, comfortably large subspace
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs0(&op, 5, 40);
+    srand(42);
+    eigs0.init();
+    int nconv0 = eigs0.compute(500);
+    REQUIRE( nconv0 == 5 );
+    ComplexVector ref = eigs0.eigenvalues();
+
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 5, 8);
+    eigs.set_ncv_bounds(8, 40, 3);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(500);
+
+    INFO( "final ncv = " << eigs.subspace_size() );
+    REQUIRE( nconv == 5 );
+
+    // Conjugate pairs of equal magnitude may come out in either order,
+    // so only the magnitudes are compared against the reference
+    ComplexVector evals = eigs.eigenvalues();
+    REQUIRE( (evals.cwiseAbs() - ref.cwiseAbs()).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    Eigen::MatrixXcd evecs = eigs.eigenvectors();
+    Eigen::MatrixXcd err = A * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Invalid ncv bounds are rejected", "[adaptive_ncv]")
+{
+    srand(123);
+    const int n = 50;
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = A + A.transpose();
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 3, 10);
+
+    REQUIRE_THROWS( eigs.set_ncv_bounds(3, 20) );
+    REQUIRE_THROWS( eigs.set_ncv_bounds(20, 10) );
+    REQUIRE_THROWS( eigs.set_ncv_bounds(10, n + 1) );
+    REQUIRE_THROWS( eigs.set_ncv_bounds(10, 20, 0) );
+}
@@ -0,0 +1,127 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <vector>
+
+#include <BatchSymEigsSolver.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+TEST_CASE("Batched symmetric solver on problems of different sizes", "[eigs_batch]")
+{
+    srand(123);
+    const int nbatch = 24;
+    const int k = 3;
+    const int m = 12;
+
+    // Random symmetric matrices of varying dimensions
+    std::vector<Matrix> mats(nbatch);
+    std::vector<DenseGenMatProd<double> *> ops(nbatch);
+    for(int j = 0; j < nbatch; j++)
+    {
+        int n = 30 + 5 * (j % 8);
+        Matrix A = Matrix::Random(n, n);
+        mats[j] = A + A.transpose();
+        ops[j] = new DenseGenMatProd<double>(mats[j]);
+    }
+
+    BatchSymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > batch(&ops[0], nbatch, k, m);
+    int nfull = batch.compute();
+
+    REQUIRE( nfull == nbatch );
+    REQUIRE( batch.num_iterations() > 0 );
+    REQUIRE( batch.num_operations() > 0 );
+
+    const Matrix &all_vals = batch.eigenvalues();
+    REQUIRE( all_vals.rows() == k );
+    REQUIRE( all_vals.cols() == nbatch );
+
+    for(int j = 0; j < nbatch; j++)
+    {
+        REQUIRE( batch.num_converged(j) == k );
+
+        Vector evals = batch.eigenvalues(j);
+        Matrix evecs = batch.eigenvectors(j);
+
+        // Packed and per-problem retrievals must agree
+        REQUIRE( (evals - all_vals.col(j)).cwiseAbs().maxCoeff() == Approx(0.0) );
+        Eigen::Map<const Matrix> slice(batch.eigenvectors_data(j), mats[j].rows(), k);
+        REQUIRE( (evecs - slice).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+        // Residuals of the computed pairs
+        Matrix err = mats[j] * evecs - evecs * evals.asDiagonal();
+        INFO( "problem " << j << ": ||AV - VD||_inf = " << err.cwiseAbs().maxCoeff() );
+        REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+
+        // Values must match the dense reference decomposition
+        Eigen::SelfAdjointEigenSolver<Matrix> ref(mats[j]);
+        double dist = 0.0;
+        for(int i = 0; i < k; i++)
+            dist = std::max(dist, (ref.eigenvalues().array() - evals[i]).abs().minCoeff());
+        REQUIRE( dist == Approx(0.0) );
+    }
+
+    for(int j = 0; j < nbatch; j++)
+        delete ops[j];
+}
+
+TEST_CASE("Batched solver is deterministic", "[eigs_batch]")
+{
+    srand(123);
+    const int nbatch = 8;
+    const int k = 4;
+    const int m = 15;
+
+    std::vector<Matrix> mats(nbatch);
+    std::vector<DenseGenMatProd<double> *> ops(nbatch);
+    for(int j = 0; j < nbatch; j++)
+    {
+        Matrix A = Matrix::Random(50, 50);
+        mats[j] = A + A.transpose();
+        ops[j] = new DenseGenMatProd<double>(mats[j]);
+    }
+
+    // Two runs with different thread counts must produce bitwise
+    // identical eigenvalues, since the initial residuals are generated
+    // from the problem index alone
+    BatchSymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > b1(&ops[0], nbatch, k, m, 1);
+    BatchSymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > b2(&ops[0], nbatch, k, m, 4);
+    b1.compute();
+    b2.compute();
+
+    REQUIRE( (b1.eigenvalues() - b2.eigenvalues()).cwiseAbs().maxCoeff() == 0.0 );
+
+    for(int j = 0; j < nbatch; j++)
+        delete ops[j];
+}
+
+TEST_CASE("Batched solver rejects invalid input", "[eigs_batch]")
+{
+    srand(123);
+    Matrix A = Matrix::Random(10, 10);
+    Matrix M = A + A.transpose();
+    DenseGenMatProd<double> op(M);
+    DenseGenMatProd<double> *ops[1] = { &op };
+
+    typedef BatchSymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > BatchSolver;
+    REQUIRE_THROWS( BatchSolver(ops, 0, 3, 6) );
+    REQUIRE_THROWS( BatchSolver(ops, 1, 3, 3) );
+    REQUIRE_THROWS( BatchSolver(ops, 1, 10, 12) );
+
+    BatchSolver batch(ops, 1, 3, 6);
+    REQUIRE_THROWS( batch.eigenvalues() );
+
+    // ncv larger than a problem dimension is clamped, not an error
+    BatchSolver clamped(ops, 1, 3, 100);
+    REQUIRE( clamped.compute() == 1 );
+    Vector evals = clamped.eigenvalues(0);
+    Eigen::SelfAdjointEigenSolver<Matrix> ref(M);
+    double dist = 0.0;
+    for(int i = 0; i < 3; i++)
+        dist = std::max(dist, (ref.eigenvalues().array() - evals[i]).abs().minCoeff());
+    REQUIRE( dist == Approx(0.0) );
+}
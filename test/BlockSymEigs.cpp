@@ -0,0 +1,96 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+
+#include <SymEigsBlockSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+#include <MatOp/SparseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+template <int SelectionRule>
+void run_test(const Matrix &mat, int k, int m, int b)
+{
+    DenseGenMatProd<double> op(mat);
+    SymEigsBlockSolver<double, SelectionRule, DenseGenMatProd<double>> eigs(&op, k, m, b);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    Matrix err = mat * evecs - evecs * evals.asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+void run_test_sets(const Matrix &mat, int k, int m, int b)
+{
+    SECTION( "Largest Magnitude" )
+    {
+        run_test<LARGEST_MAGN>(mat, k, m, b);
+    }
+    SECTION( "Largest Value" )
+    {
+        run_test<LARGEST_ALGE>(mat, k, m, b);
+    }
+    SECTION( "Smallest Value" )
+    {
+        run_test<SMALLEST_ALGE>(mat, k, m, b);
+    }
+    SECTION( "Both Ends" )
+    {
+        run_test<BOTH_ENDS>(mat, k, m, b);
+    }
+}
+
+TEST_CASE("Block eigensolver of symmetric real matrix [10x10]", "[eigs_sym_block]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(10, 10);
+    Matrix M = A + A.transpose();
+    int k = 3;
+    int m = 6;
+    int b = 2;
+
+    run_test_sets(M, k, m, b);
+}
+
+TEST_CASE("Block eigensolver of symmetric real matrix [100x100]", "[eigs_sym_block]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 30;
+    int b = 4;
+
+    run_test_sets(M, k, m, b);
+}
+
+TEST_CASE("Block eigensolver with block size not dividing ncv", "[eigs_sym_block]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 25;
+    int b = 4;
+
+    run_test_sets(M, k, m, b);
+}
@@ -0,0 +1,150 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+
+#include <SymEigsFilterSolver.h>
+#include <MatOp/SparseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+// Generate a sparse random symmetric matrix with approximately `prob`
+// nonzero ratio
+SpMatrix gen_sym_sparse_mat(int n, double prob)
+{
+    Matrix dense = Matrix::Random(n, n);
+    SpMatrix mat(n, n);
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = j; i < n; i++)
+        {
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+            {
+                mat.insert(i, j) = dense(i, j);
+                if(i != j)
+                    mat.insert(j, i) = dense(i, j);
+            }
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+// An interval around the middle of the reference spectrum, with its ends
+// placed at midpoints between neighboring eigenvalues so that membership
+// is unambiguous
+void mid_interval(const Vector &ref, int nin, double &lo, double &hi)
+{
+    const int n = ref.size();
+    const int first = (n - nin) / 2;
+    lo = 0.5 * (ref[first - 1] + ref[first]);
+    hi = 0.5 * (ref[first + nin - 1] + ref[first + nin]);
+}
+
+TEST_CASE("Interior eigenvalues through the Chebyshev filter", "[cheb_filter]")
+{
+    srand(123);
+    const int n = 500;
+    SpMatrix A = gen_sym_sparse_mat(n, 0.1);
+
+    Eigen::SelfAdjointEigenSolver<Matrix> ref((Matrix(A)));
+    const int nin = 5;
+    double lo, hi;
+    mid_interval(ref.eigenvalues(), nin, lo, hi);
+
+    SparseGenMatProd<double> op(A);
+    SymEigsFilterSolver< double, SparseGenMatProd<double> > eigs(&op, 10, 30, lo, hi, 80);
+    srand(42);
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    REQUIRE( nconv == nin );
+
+    // The estimated spectral bounds enclose the true spectrum
+    REQUIRE( eigs.spectral_lower() < ref.eigenvalues()[0] );
+    REQUIRE( eigs.spectral_upper() > ref.eigenvalues()[n - 1] );
+
+    // The recovered values match the reference values inside the interval
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    const int first = (n - nin) / 2;
+    Vector val_err = evals - ref.eigenvalues().segment(first, nin);
+    INFO( "eigenvalue error = " << val_err.cwiseAbs().maxCoeff() );
+    REQUIRE( val_err.cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // Genuine eigen pairs of the unfiltered matrix, with an orthonormal
+    // basis
+    Matrix resid = A * evecs - evecs * evals.asDiagonal();
+    INFO( "||AV - VD||_inf = " << resid.cwiseAbs().maxCoeff() );
+    REQUIRE( resid.cwiseAbs().maxCoeff() == Approx(0.0) );
+    Matrix ortho_err = evecs.transpose() * evecs - Matrix::Identity(nconv, nconv);
+    REQUIRE( ortho_err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("User-supplied spectral bounds", "[cheb_filter]")
+{
+    srand(123);
+    const int n = 300;
+    SpMatrix A = gen_sym_sparse_mat(n, 0.1);
+
+    Eigen::SelfAdjointEigenSolver<Matrix> ref((Matrix(A)));
+    const int nin = 4;
+    double lo, hi;
+    mid_interval(ref.eigenvalues(), nin, lo, hi);
+
+    // Gershgorin bounds of the matrix, independent of the reference
+    Matrix Ad(A);
+    Vector radius = Ad.cwiseAbs().rowwise().sum() - Ad.diagonal().cwiseAbs();
+    const double blo = (Ad.diagonal() - radius).minCoeff();
+    const double bhi = (Ad.diagonal() + radius).maxCoeff();
+
+    SparseGenMatProd<double> op(A);
+    SymEigsFilterSolver< double, SparseGenMatProd<double> > eigs(&op, 8, 24, lo, hi, 100);
+    eigs.set_spectral_bounds(blo, bhi);
+    srand(42);
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv == nin );
+
+    Vector evals = eigs.eigenvalues();
+    const int first = (n - nin) / 2;
+    Vector val_err = evals - ref.eigenvalues().segment(first, nin);
+    INFO( "eigenvalue error = " << val_err.cwiseAbs().maxCoeff() );
+    REQUIRE( val_err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Chebyshev filter rejects invalid input", "[cheb_filter]")
+{
+    srand(123);
+    SpMatrix A = gen_sym_sparse_mat(50, 0.3);
+    SparseGenMatProd<double> op(A);
+
+    // Degree too low
+    typedef ChebyshevFilterMatProd< double, SparseGenMatProd<double> > Filter;
+    REQUIRE_THROWS( Filter(&op, 1) );
+
+    // Interval must be set after the bounds, with lo < hi, and inside the
+    // bounds
+    Filter filter(&op, 10);
+    REQUIRE_THROWS( filter.set_interval(0.0, 1.0) );
+    filter.set_spectral_bounds(-10.0, 10.0);
+    REQUIRE_THROWS( filter.set_interval(1.0, 1.0) );
+    REQUIRE_THROWS( filter.set_interval(-20.0, 1.0) );
+    REQUIRE_THROWS( filter.set_spectral_bounds(5.0, -5.0) );
+
+    // The solver checks its interval and requires compute() before the
+    // accessors
+    typedef SymEigsFilterSolver< double, SparseGenMatProd<double> > Solver;
+    REQUIRE_THROWS( Solver(&op, 3, 10, 2.0, 1.0) );
+    Solver eigs(&op, 3, 10, -1.0, 1.0);
+    REQUIRE_THROWS( eigs.eigenvalues() );
+}
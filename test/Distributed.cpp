@@ -0,0 +1,197 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+Matrix gen_sym_mat(int n)
+{
+    Matrix A = Matrix::Random(n, n);
+    return 0.5 * (A + A.transpose());
+}
+
+// With a single rank the all-reduce sum is the identity; this hook only
+// counts how often the solver asks for a reduction
+static void counting_reduce(double *buf, int len, void *data)
+{
+    (void) buf;
+    (void) len;
+    int *cnt = static_cast<int *>(data);
+    (*cnt)++;
+}
+
+TEST_CASE("Reduction hook on a single rank is transparent", "[distributed]")
+{
+    srand(123);
+    const int n = 300;
+    Matrix M = gen_sym_mat(n);
+    const int k = 5;
+    const int m = 20;
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs_ref(&op, k, m);
+    srand(42);
+    eigs_ref.init();
+    eigs_ref.compute();
+
+    int ncalls = 0;
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+    eigs.set_reduction_hook(counting_reduce, &ncalls);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv == k );
+    REQUIRE( ncalls > 0 );
+
+    // Exactly the same arithmetic as the run without the hook
+    Vector evals = eigs.eigenvalues();
+    Vector evals_ref = eigs_ref.eigenvalues();
+    REQUIRE( (evals - evals_ref).cwiseAbs().maxCoeff() == 0.0 );
+    Matrix evecs = eigs.eigenvectors();
+    Matrix evecs_ref = eigs_ref.eigenvectors();
+    REQUIRE( (evecs - evecs_ref).cwiseAbs().maxCoeff() == 0.0 );
+}
+
+#ifdef _OPENMP
+
+// Shared state of the thread-simulated ranks below. OpenMP threads stand
+// in for MPI ranks: the all-reduce hook sums the partial results of both
+// ranks under a critical section and hands the total back to everyone,
+// and the row-slice operator publishes its local slice of x before
+// computing its local rows of M * x (the "halo exchange" of a dense
+// operator is a full gather)
+struct ReduceShared
+{
+    double acc[64];
+};
+
+static void omp_allreduce(double *buf, int len, void *data)
+{
+    ReduceShared *sh = static_cast<ReduceShared *>(data);
+    #pragma omp critical (dist_reduce)
+    {
+        for(int i = 0; i < len; i++)
+            sh->acc[i] += buf[i];
+    }
+    #pragma omp barrier
+    for(int i = 0; i < len; i++)
+        buf[i] = sh->acc[i];
+    #pragma omp barrier
+    #pragma omp single
+    {
+        for(int i = 0; i < 64; i++)
+            sh->acc[i] = 0.0;
+    }
+}
+
+class RowSliceOp
+{
+private:
+    const Matrix &mat;
+    const int row_start;
+    const int nlocal;
+    Vector &x_glob;
+
+public:
+    RowSliceOp(const Matrix &mat_, int row_start_, int nlocal_, Vector &x_glob_) :
+        mat(mat_), row_start(row_start_), nlocal(nlocal_), x_glob(x_glob_)
+    {}
+
+    int rows() { return nlocal; }
+    int cols() { return nlocal; }
+
+    void perform_op(double *x_in, double *y_out)
+    {
+        std::copy(x_in, x_in + nlocal, &x_glob[row_start]);
+        #pragma omp barrier
+        Eigen::Map<Vector> y(y_out, nlocal);
+        y.noalias() = mat.middleRows(row_start, nlocal) * x_glob;
+        #pragma omp barrier
+    }
+};
+
+TEST_CASE("Two row-sliced ranks agree with the global solve", "[distributed]")
+{
+    srand(123);
+    const int n = 400;
+    Matrix M = gen_sym_mat(n);
+    const int k = 5;
+    const int m = 20;
+    // Uneven slices, to exercise the offsets
+    const int split[3] = { 0, 250, n };
+
+    // The ranks run in lockstep through the barriers, which needs an
+    // actual team of two (oversubscribing a single core is fine)
+    omp_set_dynamic(0);
+    int team = 0;
+    #pragma omp parallel num_threads(2)
+    {
+        #pragma omp single
+        team = omp_get_num_threads();
+    }
+    if(team != 2)
+        return;
+
+    // Global reference solve
+    DenseGenMatProd<double> op_ref(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs_ref(&op_ref, k, m);
+    srand(42);
+    eigs_ref.init();
+    eigs_ref.compute();
+    Vector evals_ref = eigs_ref.eigenvalues();
+
+    // Both ranks start from the same global residual vector
+    Vector resid0 = Vector::Random(n);
+
+    ReduceShared shared = { {0.0} };
+    Vector x_glob(n);
+    Matrix evals_out(k, 2);
+    Matrix evecs_glob(n, k);
+    int nconv_out[2] = { 0, 0 };
+
+    #pragma omp parallel num_threads(2)
+    {
+        const int rank = omp_get_thread_num();
+        const int lo = split[rank], nl = split[rank + 1] - lo;
+
+        RowSliceOp op(M, lo, nl, x_glob);
+        SymEigsSolver<double, LARGEST_MAGN, RowSliceOp> eigs(&op, k, m);
+        eigs.set_reduction_hook(omp_allreduce, &shared);
+        eigs.init(&resid0[lo]);
+        nconv_out[rank] = eigs.compute();
+
+        evals_out.col(rank) = eigs.eigenvalues();
+        evecs_glob.middleRows(lo, nl) = eigs.eigenvectors();
+    }
+
+    REQUIRE( nconv_out[0] == k );
+    REQUIRE( nconv_out[1] == k );
+
+    // The replicated Ritz values are identical on the two ranks
+    REQUIRE( (evals_out.col(0) - evals_out.col(1)).cwiseAbs().maxCoeff() == 0.0 );
+
+    // And agree with the global solve
+    Vector evals = evals_out.col(0);
+    REQUIRE( (evals - evals_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // The gathered row slices form genuine global eigen pairs
+    Matrix err = M * evecs_glob - evecs_glob * evals.asDiagonal();
+    INFO( "||AV - VD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+    Matrix ortho = evecs_glob.transpose() * evecs_glob - Matrix::Identity(k, k);
+    REQUIRE( ortho.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+#endif // _OPENMP
@@ -54,6 +54,36 @@ TEST_CASE("Eigen decomposition of upper Hessenberg matrix", "[Eigen]")
               << double(t2 - t1) / CLOCKS_PER_SEC << " secs\n";
 }
 
+TEST_CASE("Values-only mode of upper Hessenberg eigen decomposition", "[Eigen]")
+{
+    srand(123);
+    int n = 100;
+    MatrixXd m = MatrixXd::Random(n, n);
+    m.array() -= 0.5;
+    MatrixXd H = m.triangularView<Eigen::Upper>();
+    H.diagonal(-1) = m.diagonal(-1);
+
+    UpperHessenbergEigen<double> full(H);
+    VectorXcd evals_full = full.eigenvalues();
+    MatrixXcd evecs = full.eigenvectors();
+
+    UpperHessenbergEigen<double> vals;
+    vals.compute(H, false);
+    VectorXcd evals = vals.eigenvalues();
+    VectorXcd brow = vals.eigenvectors_bottom_row();
+
+    REQUIRE( (evals - evals_full).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // The bottom row must agree with the last row of the full
+    // (normalized) eigenvector matrix
+    VectorXcd brow_full = evecs.row(n - 1).transpose();
+    INFO( "max error of bottom row = " << (brow - brow_full).cwiseAbs().maxCoeff() );
+    REQUIRE( (brow - brow_full).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // Full eigenvectors are not available in this mode
+    REQUIRE_THROWS( vals.eigenvectors() );
+}
+
 TEST_CASE("Eigen decomposition of symmetric tridiagonal matrix", "[Eigen]")
 {
     srand(123);
@@ -97,3 +127,32 @@ TEST_CASE("Eigen decomposition of symmetric tridiagonal matrix", "[Eigen]")
     std::cout << "elapsed time for Eigen::SelfAdjointEigenSolver: "
               << double(t2 - t1) / CLOCKS_PER_SEC << " secs\n";
 }
+
+TEST_CASE("Values-only mode of symmetric tridiagonal eigen decomposition", "[Eigen]")
+{
+    srand(123);
+    int n = 100;
+    MatrixXd m = MatrixXd::Random(n, n);
+    m.array() -= 0.5;
+    MatrixXd H = MatrixXd::Zero(n, n);
+    H.diagonal() = m.diagonal();
+    H.diagonal(-1) = m.diagonal(-1);
+    H.diagonal(1) = m.diagonal(-1);
+
+    TridiagEigen<double> full(H);
+    VectorXd evals_full = full.eigenvalues();
+    MatrixXd evecs = full.eigenvectors();
+
+    TridiagEigen<double> vals;
+    vals.compute(H, false);
+    VectorXd evals = vals.eigenvalues();
+    VectorXd brow = vals.eigenvectors_bottom_row();
+
+    REQUIRE( (evals - evals_full).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    VectorXd brow_full = evecs.row(n - 1).transpose();
+    INFO( "max error of bottom row = " << (brow - brow_full).cwiseAbs().maxCoeff() );
+    REQUIRE( (brow - brow_full).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    REQUIRE_THROWS( vals.eigenvectors() );
+}
@@ -0,0 +1,107 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+
+#include <HermEigsSolver.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXcd ComplexMatrix;
+typedef Eigen::VectorXcd ComplexVector;
+typedef std::complex<double> Complex;
+
+template <int SelectionRule>
+void run_test(const ComplexMatrix &mat, int k, int m)
+{
+    DenseGenMatProd<Complex> op(mat);
+    HermEigsSolver<double, SelectionRule, DenseGenMatProd<Complex> > eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs.eigenvalues();
+    ComplexMatrix evecs = eigs.eigenvectors();
+
+    // The eigenvalues are real, so D is a real diagonal
+    ComplexMatrix err = mat * evecs - evecs * evals.cast<Complex>().asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+void run_test_sets(const ComplexMatrix &A, int k, int m)
+{
+    SECTION( "Largest Magnitude" )
+    {
+        run_test<LARGEST_MAGN>(A, k, m);
+    }
+    SECTION( "Largest Value" )
+    {
+        run_test<LARGEST_ALGE>(A, k, m);
+    }
+    SECTION( "Smallest Value" )
+    {
+        run_test<SMALLEST_ALGE>(A, k, m);
+    }
+    SECTION( "Both Ends" )
+    {
+        run_test<BOTH_ENDS>(A, k, m);
+    }
+}
+
+TEST_CASE("Eigensolver of Hermitian matrices [10x10]", "[eigs_herm]")
+{
+    srand(123);
+    ComplexMatrix A = ComplexMatrix::Random(10, 10);
+    ComplexMatrix mat = A + A.adjoint();
+    int k = 3;
+    int m = 6;
+
+    run_test_sets(mat, k, m);
+}
+
+TEST_CASE("Eigensolver of Hermitian matrices [100x100]", "[eigs_herm]")
+{
+    srand(123);
+    ComplexMatrix A = ComplexMatrix::Random(100, 100);
+    ComplexMatrix mat = A + A.adjoint();
+    int k = 10;
+    int m = 20;
+
+    run_test_sets(mat, k, m);
+}
+
+TEST_CASE("Hermitian eigenvalues match the dense reference", "[eigs_herm]")
+{
+    srand(123);
+    const int n = 100;
+    ComplexMatrix A = ComplexMatrix::Random(n, n);
+    ComplexMatrix mat = A + A.adjoint();
+
+    Eigen::SelfAdjointEigenSolver<ComplexMatrix> es(mat);
+    Vector ref = es.eigenvalues().tail(5).reverse();
+
+    DenseGenMatProd<Complex> op(mat);
+    HermEigsSolver<double, LARGEST_ALGE, DenseGenMatProd<Complex> > eigs(&op, 5, 15);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv == 5 );
+    Vector evals = eigs.eigenvalues();
+    REQUIRE( (evals - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // Eigenvectors of distinct eigenvalues must be unitary to each other
+    ComplexMatrix evecs = eigs.eigenvectors();
+    ComplexMatrix orth = evecs.adjoint() * evecs - ComplexMatrix::Identity(5, 5);
+    INFO( "||U^H U - I||_inf = " << orth.array().abs().maxCoeff() );
+    REQUIRE( orth.array().abs().maxCoeff() == Approx(0.0) );
+}
@@ -0,0 +1,103 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+// A matrix with a given spectrum: a dense bulk plus a few separated
+// eigenvalues, so that most wanted pairs converge (and get locked) early
+// while the ones near the bulk need many more iterations
+Matrix mat_with_spectrum(const Vector &d)
+{
+    const int n = d.size();
+    Matrix A = Eigen::MatrixXd::Random(n, n);
+    Matrix Q = Eigen::HouseholderQR<Matrix>(A).householderQ();
+    Matrix M = Q * d.asDiagonal() * Q.transpose();
+    return 0.5 * (M + M.transpose());
+}
+
+template <int SelectionRule>
+void run_test(const Matrix &mat, int k, int m)
+{
+    DenseGenMatProd<double> op(mat);
+    SymEigsSolver<double, SelectionRule, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute(3000);
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv == k );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    Matrix err = mat * evecs - evecs * evals.asDiagonal();
+    Matrix orth = evecs.transpose() * evecs - Matrix::Identity(nconv, nconv);
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    INFO( "||U'U - I||_inf = " << orth.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+    // The locked columns must stay orthogonal to the ones that keep
+    // being refined after the locking
+    REQUIRE( orth.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Locking with eigenvalues converging at very different speeds", "[eigs_sym]")
+{
+    srand(123);
+
+    const int n = 1000;
+    Vector d(n);
+    for(int i = 0; i < n; i++)
+        d[i] = 1.0 + 0.001 * i;     // bulk in [1, 2]
+    d[n - 1] = 100; d[n - 2] = 90; d[n - 3] = 80;
+    d[n - 4] = 70;  d[n - 5] = 60; d[n - 6] = 50;
+    d[n - 7] = 2.10; d[n - 8] = 2.05;  // barely separated from the bulk
+    Matrix M = mat_with_spectrum(d);
+
+    SECTION( "Largest Value" )
+    {
+        run_test<LARGEST_ALGE>(M, 8, 16);
+    }
+    SECTION( "Largest Magnitude" )
+    {
+        run_test<LARGEST_MAGN>(M, 8, 16);
+    }
+}
+
+TEST_CASE("Locking at both ends of the spectrum", "[eigs_sym]")
+{
+    srand(123);
+
+    const int n = 1000;
+    Vector d(n);
+    for(int i = 0; i < n; i++)
+        d[i] = 10.0 + 0.001 * i;    // bulk in [10, 11]
+    d[0] = -50; d[1] = -40;
+    d[n - 1] = 100; d[n - 2] = 90;
+    d[n - 3] = 11.2;                 // slow one near the bulk
+    Matrix M = mat_with_spectrum(d);
+
+    run_test<BOTH_ENDS>(M, 5, 12);
+}
+
+TEST_CASE("Locking on a small matrix", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+
+    run_test<LARGEST_MAGN>(M, 10, 20);
+}
@@ -0,0 +1,84 @@
+#include <Eigen/Core>
+#include <iostream>
+#include <cstdio>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MMapBasisStorage.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXcd ComplexMatrix;
+typedef Eigen::VectorXcd ComplexVector;
+
+TEST_CASE("Memory-mapped basis, symmetric solver", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(500, 500);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    DenseGenMatProd<double> op(M);
+
+    // Reference solve with the in-RAM basis
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> ref(&op, k, m);
+    srand(42);
+    ref.init();
+    int nconv_ref = ref.compute();
+    Vector evals_ref = ref.eigenvalues();
+
+    // Same solve with the basis in a memory-mapped file
+    const char *file = "mmap_basis_test.bin";
+    {
+        MMapBasisStorage<double> storage(file, 500, m);
+        SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m, storage.data());
+        srand(42);
+        eigs.init();
+        int nconv = eigs.compute();
+
+        REQUIRE( nconv == nconv_ref );
+
+        Vector evals = eigs.eigenvalues();
+        Matrix evecs = eigs.eigenvectors();
+        REQUIRE( (evals - evals_ref).array().abs().maxCoeff() == Approx(0.0) );
+
+        Matrix err = M * evecs - evecs * evals.asDiagonal();
+        INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+        REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+    }
+    std::remove(file);
+}
+
+TEST_CASE("Memory-mapped basis, general solver", "[eigs_gen]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(500, 500);
+    int k = 10;
+    int m = 30;
+
+    DenseGenMatProd<double> op(A);
+
+    const char *file = "mmap_basis_test_gen.bin";
+    {
+        MMapBasisStorage<double> storage(file, 500, m);
+        GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m, storage.data());
+        eigs.init();
+        int nconv = eigs.compute();
+
+        REQUIRE( nconv > 0 );
+
+        ComplexVector evals = eigs.eigenvalues();
+        ComplexMatrix evecs = eigs.eigenvectors();
+        ComplexMatrix err = A * evecs - evecs * evals.asDiagonal();
+        INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+        REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+    }
+    std::remove(file);
+}
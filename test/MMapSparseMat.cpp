@@ -0,0 +1,143 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+#include <cstdio>
+
+#include <SymEigsSolver.h>
+#include <MatOp/SparseGenMatProd.h>
+#include <MatOp/MMapSparseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+// Generate a sparse random matrix with approximately `prob` nonzero ratio
+SpMatrix gen_sparse_mat(int n, double prob)
+{
+    Matrix dense = Matrix::Random(n, n);
+    SpMatrix mat(n, n);
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+                mat.insert(i, j) = dense(i, j);
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+// A scratch file removed when the guard goes out of scope
+struct ScratchFile
+{
+    std::string path;
+    ScratchFile(const std::string &path_) : path(path_) {}
+    ~ScratchFile() { std::remove(path.c_str()); }
+};
+
+TEST_CASE("Binary file round trip", "[mmap_sparse]")
+{
+    srand(123);
+    const int n = 200;
+    SpMatrix A = gen_sparse_mat(n, 0.1);
+
+    ScratchFile file("mmap_sparse_roundtrip.bin");
+    MMapSparseGenMatProd<double>::save(file.path, A);
+
+    MMapSparseGenMatProd<double> op(file.path);
+    REQUIRE( op.rows() == n );
+    REQUIRE( op.cols() == n );
+    REQUIRE( op.nonzeros() == A.nonZeros() );
+
+    // The mapped SpMV agrees with the in-memory product
+    Vector x = Vector::Random(n);
+    Vector y(n);
+    op.perform_op(x.data(), y.data());
+    Vector y_ref = A * x;
+    REQUIRE( (y - y_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // An uncompressed input is compressed on the fly by save()
+    SpMatrix B = gen_sparse_mat(n, 0.05);
+    B.uncompress();
+    ScratchFile file2("mmap_sparse_uncompressed.bin");
+    MMapSparseGenMatProd<double>::save(file2.path, B);
+    MMapSparseGenMatProd<double> op2(file2.path);
+    op2.perform_op(x.data(), y.data());
+    y_ref = B * x;
+    REQUIRE( (y - y_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Eigen solve over the mapped operator", "[mmap_sparse]")
+{
+    srand(123);
+    const int n = 500;
+    SpMatrix A = gen_sparse_mat(n, 0.1);
+    SpMatrix M = SpMatrix(A.transpose()) + A;  // symmetric
+
+    ScratchFile file("mmap_sparse_solve.bin");
+    MMapSparseGenMatProd<double>::save(file.path, M);
+
+    const int k = 5;
+    const int m = 20;
+
+    // Reference solve on the in-memory matrix
+    SparseGenMatProd<double> op_mem(M);
+    SymEigsSolver<double, LARGEST_MAGN, SparseGenMatProd<double> > eigs_mem(&op_mem, k, m);
+    srand(42);
+    eigs_mem.init();
+    eigs_mem.compute();
+
+    MMapSparseGenMatProd<double> op(file.path);
+    SymEigsSolver<double, LARGEST_MAGN, MMapSparseGenMatProd<double> > eigs(&op, k, m);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    REQUIRE( nconv == k );
+
+    // Same arithmetic, same answer
+    Vector evals = eigs.eigenvalues();
+    Vector evals_mem = eigs_mem.eigenvalues();
+    REQUIRE( (evals - evals_mem).cwiseAbs().maxCoeff() == 0.0 );
+
+    Matrix evecs = eigs.eigenvectors();
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Loader rejects invalid files", "[mmap_sparse]")
+{
+    // Missing file
+    REQUIRE_THROWS( MMapSparseGenMatProd<double>("no_such_matrix.bin") );
+
+    // Wrong magic
+    ScratchFile bad("mmap_sparse_bad.bin");
+    std::FILE *fp = std::fopen(bad.path.c_str(), "wb");
+    const char junk[64] = "not a matrix";
+    std::fwrite(junk, 1, sizeof(junk), fp);
+    std::fclose(fp);
+    REQUIRE_THROWS( MMapSparseGenMatProd<double>(bad.path) );
+
+    // Scalar type mismatch: saved as double, opened as float
+    srand(123);
+    SpMatrix A = gen_sparse_mat(50, 0.2);
+    ScratchFile file("mmap_sparse_scalar.bin");
+    MMapSparseGenMatProd<double>::save(file.path, A);
+    REQUIRE_THROWS( MMapSparseGenMatProd<float>(file.path) );
+
+    // Truncated file
+    ScratchFile trunc("mmap_sparse_trunc.bin");
+    MMapSparseGenMatProd<double>::save(trunc.path, A);
+    REQUIRE( ::truncate(trunc.path.c_str(), 100) == 0 );
+    REQUIRE_THROWS( MMapSparseGenMatProd<double>(trunc.path) );
+}
@@ -0,0 +1,151 @@
+#include <Eigen/Core>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <TridiagEigen.h>
+#include <UpperHessenbergQR.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXcd ComplexMatrix;
+typedef Eigen::VectorXcd ComplexVector;
+
+// A fixed-capacity solver must reproduce the dynamic solver bit for bit,
+// since MaxNcv only changes where the ncv-sized workspaces are stored
+TEST_CASE("Fixed-capacity symmetric solver matches the dynamic one", "[max_ncv]")
+{
+    srand(42);
+
+    const int n = 100;
+    const int k = 5;
+    const int m = 20;
+    Matrix A = Eigen::MatrixXd::Random(n, n);
+    Matrix M = A + A.transpose();
+    Vector resid0 = Eigen::VectorXd::Random(n);
+
+    DenseGenMatProd<double> op_dyn(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs_dyn(&op_dyn, k, m);
+    eigs_dyn.init(resid0.data());
+    int nconv_dyn = eigs_dyn.compute();
+
+    DenseGenMatProd<double> op_fix(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+                  NullSolverStats<double>, 32> eigs_fix(&op_fix, k, m);
+    eigs_fix.init(resid0.data());
+    int nconv_fix = eigs_fix.compute();
+
+    REQUIRE( nconv_dyn == k );
+    REQUIRE( nconv_fix == nconv_dyn );
+    REQUIRE( eigs_fix.num_iterations() == eigs_dyn.num_iterations() );
+
+    Vector evals_dyn = eigs_dyn.eigenvalues();
+    Vector evals_fix = eigs_fix.eigenvalues();
+    Matrix evecs_dyn = eigs_dyn.eigenvectors();
+    Matrix evecs_fix = eigs_fix.eigenvectors();
+
+    REQUIRE( (evals_fix - evals_dyn).array().abs().maxCoeff() == 0.0 );
+    REQUIRE( (evecs_fix - evecs_dyn).array().abs().maxCoeff() == 0.0 );
+}
+
+TEST_CASE("Fixed-capacity general solver matches the dynamic one", "[max_ncv]")
+{
+    srand(42);
+
+    const int n = 100;
+    const int k = 5;
+    const int m = 20;
+    Matrix A = Eigen::MatrixXd::Random(n, n);
+    Vector resid0 = Eigen::VectorXd::Random(n);
+
+    DenseGenMatProd<double> op_dyn(A);
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs_dyn(&op_dyn, k, m);
+    eigs_dyn.init(resid0.data());
+    int nconv_dyn = eigs_dyn.compute();
+
+    DenseGenMatProd<double> op_fix(A);
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+                  NullSolverStats<double>, HostBasisGemv<double>, 32> eigs_fix(&op_fix, k, m);
+    eigs_fix.init(resid0.data());
+    int nconv_fix = eigs_fix.compute();
+
+    REQUIRE( nconv_dyn == k );
+    REQUIRE( nconv_fix == nconv_dyn );
+    REQUIRE( eigs_fix.num_iterations() == eigs_dyn.num_iterations() );
+
+    ComplexVector evals_dyn = eigs_dyn.eigenvalues();
+    ComplexVector evals_fix = eigs_fix.eigenvalues();
+    ComplexMatrix evecs_dyn = eigs_dyn.eigenvectors();
+    ComplexMatrix evecs_fix = eigs_fix.eigenvectors();
+
+    REQUIRE( (evals_fix - evals_dyn).array().abs().maxCoeff() == 0.0 );
+    REQUIRE( (evecs_fix - evecs_dyn).array().abs().maxCoeff() == 0.0 );
+}
+
+TEST_CASE("Fixed-capacity decomposition classes match the dynamic ones", "[max_ncv]")
+{
+    srand(42);
+
+    const int n = 20;
+    Matrix A = Eigen::MatrixXd::Random(n, n);
+    Matrix T = Matrix::Zero(n, n);
+    T.diagonal() = A.diagonal();
+    T.diagonal(1) = A.diagonal(1);
+    T.diagonal(-1) = A.diagonal(1);
+
+    SECTION( "TridiagEigen" )
+    {
+        TridiagEigen<double> decomp_dyn(T);
+        TridiagEigen<double, 32> decomp_fix(T);
+
+        Vector evals_dyn = decomp_dyn.eigenvalues();
+        Vector evals_fix = decomp_fix.eigenvalues();
+        Matrix evecs_dyn = decomp_dyn.eigenvectors();
+        Matrix evecs_fix = decomp_fix.eigenvectors();
+
+        REQUIRE( (evals_fix - evals_dyn).array().abs().maxCoeff() == 0.0 );
+        REQUIRE( (evecs_fix - evecs_dyn).array().abs().maxCoeff() == 0.0 );
+    }
+    SECTION( "TridiagQR" )
+    {
+        TridiagQR<double> decomp_dyn(T);
+        TridiagQR<double, 32> decomp_fix(T);
+
+        Matrix RQ_dyn = decomp_dyn.matrix_RQ();
+        Matrix RQ_fix = decomp_fix.matrix_RQ();
+
+        REQUIRE( (RQ_fix - RQ_dyn).array().abs().maxCoeff() == 0.0 );
+    }
+}
+
+TEST_CASE("Oversized problems are rejected", "[max_ncv]")
+{
+    srand(42);
+
+    const int n = 100;
+    Matrix A = Eigen::MatrixXd::Random(n, n);
+    Matrix M = A + A.transpose();
+    DenseGenMatProd<double> op(M);
+
+    typedef SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+                          NullSolverStats<double>, 16> SmallSolver;
+
+    // ncv larger than the compile-time bound
+    REQUIRE_THROWS( SmallSolver(&op, 5, 20) );
+
+    // adaptive bounds exceeding the compile-time bound
+    SmallSolver eigs(&op, 5, 12);
+    REQUIRE_THROWS( eigs.set_ncv_bounds(12, 20) );
+
+    // direct use of a decomposition class beyond its capacity
+    Matrix T = Matrix::Zero(n, n);
+    T.diagonal() = M.diagonal();
+    T.diagonal(1) = M.diagonal(1);
+    T.diagonal(-1) = M.diagonal(1);
+    TridiagEigen<double, 16> decomp;
+    REQUIRE_THROWS( decomp.compute(T) );
+}
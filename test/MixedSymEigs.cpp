@@ -0,0 +1,92 @@
+#include <Eigen/Core>
+#include <iostream>
+
+#include <SymEigsMixedSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXf MatrixF;
+
+template <int SelectionRule>
+void run_test(const Matrix &mat, int k, int m)
+{
+    MatrixF matf = mat.cast<float>();
+    DenseGenMatProd<float> op_f(matf);
+    DenseGenMatProd<double> op_d(mat);
+    SymEigsMixedSolver<SelectionRule> eigs(&op_f, &op_d, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    Matrix err = mat * evecs - evecs * evals.asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    // The refined pairs should reach double accuracy, well beyond the
+    // single precision limit of the Lanczos phase
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+void run_test_sets(const Matrix &mat, int k, int m)
+{
+    SECTION( "Largest Magnitude" )
+    {
+        run_test<LARGEST_MAGN>(mat, k, m);
+    }
+    SECTION( "Largest Value" )
+    {
+        run_test<LARGEST_ALGE>(mat, k, m);
+    }
+    SECTION( "Both Ends" )
+    {
+        run_test<BOTH_ENDS>(mat, k, m);
+    }
+}
+
+TEST_CASE("Mixed-precision eigensolver of symmetric real matrix [10x10]", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(10, 10);
+    Matrix M = A + A.transpose();
+    int k = 3;
+    int m = 6;
+
+    run_test_sets(M, k, m);
+}
+
+TEST_CASE("Mixed-precision eigensolver of symmetric real matrix [100x100]", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    run_test_sets(M, k, m);
+}
+
+TEST_CASE("Mixed-precision eigensolver of symmetric real matrix [1000x1000]", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(1000, 1000);
+    Matrix M = A + A.transpose();
+    int k = 20;
+    int m = 50;
+
+    run_test_sets(M, k, m);
+}
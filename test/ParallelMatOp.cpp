@@ -0,0 +1,115 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+#include <MatOp/SparseGenMatProd.h>
+#include <MatOp/ParallelDenseGenMatProd.h>
+#include <MatOp/ParallelSparseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+TEST_CASE("Parallel dense mat-vec product", "[parallel_op]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Vector x = Eigen::VectorXd::Random(100);
+    Vector y_serial(100), y_parallel(100);
+
+    DenseGenMatProd<double> op_serial(A);
+    op_serial.perform_op(x.data(), y_serial.data());
+
+    // Test different numbers of row blocks, including counts
+    // that do not divide the matrix size evenly
+    int nthreads[] = {1, 2, 3, 7, 67, 100};
+    for(unsigned int i = 0; i < sizeof(nthreads) / sizeof(int); i++)
+    {
+        ParallelDenseGenMatProd<double> op(A, nthreads[i]);
+        op.perform_op(x.data(), y_parallel.data());
+
+        INFO( "nthread = " << nthreads[i] );
+        REQUIRE( (y_serial - y_parallel).array().abs().maxCoeff() == Approx(0.0) );
+    }
+}
+
+TEST_CASE("Parallel dense mat-vec product with empty tail blocks", "[parallel_op]")
+{
+    srand(123);
+
+    // nrow = 65 with 64 blocks gives block_size = 2, so the row range is
+    // exhausted after 33 blocks and the remaining ones must be skipped
+    Matrix A = Eigen::MatrixXd::Random(65, 65);
+    Vector x = Eigen::VectorXd::Random(65);
+    Vector y_serial(65), y_parallel(65);
+
+    DenseGenMatProd<double> op_serial(A);
+    op_serial.perform_op(x.data(), y_serial.data());
+
+    ParallelDenseGenMatProd<double> op(A, 64);
+    op.perform_op(x.data(), y_parallel.data());
+
+    REQUIRE( (y_serial - y_parallel).array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Parallel sparse mat-vec product", "[parallel_op]")
+{
+    srand(123);
+
+    // A sparse random matrix with roughly 10% nonzero elements
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    SpMatrix M(100, 100);
+    for(int j = 0; j < 100; j++)
+    {
+        for(int i = 0; i < 100; i++)
+        {
+            if(std::abs(A(i, j)) < 0.1)
+                M.insert(i, j) = A(i, j);
+        }
+    }
+    M.makeCompressed();
+
+    Vector x = Eigen::VectorXd::Random(100);
+    Vector y_serial(100), y_parallel(100);
+
+    SparseGenMatProd<double> op_serial(M);
+    op_serial.perform_op(x.data(), y_serial.data());
+
+    int nthreads[] = {1, 2, 3, 7, 100};
+    for(unsigned int i = 0; i < sizeof(nthreads) / sizeof(int); i++)
+    {
+        ParallelSparseGenMatProd<double> op(M, nthreads[i]);
+        op.perform_op(x.data(), y_parallel.data());
+
+        INFO( "nthread = " << nthreads[i] );
+        REQUIRE( (y_serial - y_parallel).array().abs().maxCoeff() == Approx(0.0) );
+    }
+}
+
+TEST_CASE("Eigensolver with parallel dense mat-vec product", "[parallel_op]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+
+    ParallelDenseGenMatProd<double> op(M, 4);
+    SymEigsSolver<double, LARGEST_MAGN, ParallelDenseGenMatProd<double>> eigs(&op, 10, 20);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
@@ -0,0 +1,91 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SVD>
+#include <iostream>
+
+#include <PartialSVDSolver.h>
+#include <MatOp/SparseSVDMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+// Generate a sparse random matrix with approximately `prob` nonzero ratio
+SpMatrix gen_sparse_mat(int m, int n, double prob)
+{
+    Matrix dense = Matrix::Random(m, n);
+    SpMatrix mat(m, n);
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = 0; i < m; i++)
+        {
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+                mat.insert(i, j) = dense(i, j);
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+template <typename OpType>
+void check_svd(const Matrix &A, OpType &op, int k, int m)
+{
+    PartialSVDSolver<double, OpType> svds(&op, k, m);
+    srand(42);
+    int nconv = svds.compute();
+
+    REQUIRE( nconv == k );
+
+    Vector S = svds.singular_values();
+    Matrix U = svds.matrix_U(nconv);
+    Matrix V = svds.matrix_V(nconv);
+
+    REQUIRE( U.rows() == A.rows() );
+    REQUIRE( V.rows() == A.cols() );
+
+    // Reference singular values from the dense decomposition
+    Eigen::JacobiSVD<Matrix> svd(A);
+    Vector ref = svd.singularValues().head(k);
+    REQUIRE( (S - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // A * V = U * S and orthonormality of both factors
+    Matrix err = A * V - U * S.asDiagonal();
+    INFO( "||AV - US||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    Matrix orthU = U.transpose() * U - Matrix::Identity(k, k);
+    Matrix orthV = V.transpose() * V - Matrix::Identity(k, k);
+    REQUIRE( orthU.cwiseAbs().maxCoeff() == Approx(0.0) );
+    REQUIRE( orthV.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Partial SVD of a tall dense matrix", "[partial_svd]")
+{
+    srand(123);
+    Matrix A = Matrix::Random(500, 60);
+
+    DenseSVDMatProd<double> op(A);
+    check_svd(A, op, 5, 20);
+}
+
+TEST_CASE("Partial SVD of a wide dense matrix", "[partial_svd]")
+{
+    srand(123);
+    Matrix A = Matrix::Random(60, 500);
+
+    DenseSVDMatProd<double> op(A);
+    check_svd(A, op, 5, 20);
+}
+
+TEST_CASE("Partial SVD of a tall sparse matrix", "[partial_svd]")
+{
+    srand(123);
+    SpMatrix A = gen_sparse_mat(1000, 80, 0.1);
+    Matrix Adense = Matrix(A);
+
+    SparseSVDMatProd<double> op(A);
+    check_svd(Adense, op, 5, 20);
+}
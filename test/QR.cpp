@@ -117,6 +117,70 @@ TEST_CASE("QR of Tridiagonal matrix", "[QR]")
     run_test< TridiagQR<double> >(Hmap);
 }
 
+// Reference implementation of the multi-shift sweep: apply the shifts
+// one at a time, as the solvers did before sweep_shifts() existed
+template <typename Solver>
+void shift_loop(MatrixXd &H, const VectorXd &shifts, MatrixXd &Q)
+{
+    Solver decomp;
+    for(int i = 0; i < shifts.size(); i++)
+    {
+        H.diagonal().array() -= shifts[i];
+        decomp.compute(H);
+        decomp.apply_YQ(Q);
+        decomp.matrix_RQ(H);
+        H.diagonal().array() += shifts[i];
+    }
+}
+
+template <typename Solver>
+void run_sweep_test(const MatrixXd &H, const VectorXd &shifts)
+{
+    int n = H.rows();
+
+    MatrixXd H_ref = H;
+    MatrixXd Q_ref = MatrixXd::Identity(n, n);
+    shift_loop<Solver>(H_ref, shifts, Q_ref);
+
+    MatrixXd H_new = H;
+    MatrixXd Q_new = MatrixXd::Identity(n, n);
+    Solver decomp;
+    decomp.sweep_shifts(H_new, shifts, Q_new);
+
+    INFO( "max error of H = " << (H_new - H_ref).cwiseAbs().maxCoeff() );
+    REQUIRE( (H_new - H_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+    INFO( "max error of Q = " << (Q_new - Q_ref).cwiseAbs().maxCoeff() );
+    REQUIRE( (Q_new - Q_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // The accumulator may also be rectangular, as in the locking case
+    // where only the active block of the basis is rotated
+    MatrixXd Y = MatrixXd::Random(2 * n + 1, n);
+    MatrixXd YQ_ref = Y * Q_ref;
+    MatrixXd H_y = H;
+    decomp.sweep_shifts(H_y, shifts, Y);
+    INFO( "max error of YQ = " << (Y - YQ_ref).cwiseAbs().maxCoeff() );
+    REQUIRE( (Y - YQ_ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Fused multi-shift QR sweeps", "[QR]")
+{
+    srand(123);
+    int n = 100;
+    MatrixXd m = MatrixXd::Random(n, n);
+    m.array() -= 0.5;
+    VectorXd shifts = VectorXd::Random(n / 2);
+
+    MatrixXd H = m.triangularView<Eigen::Upper>();
+    H.diagonal(-1) = m.diagonal(-1);
+    run_sweep_test< UpperHessenbergQR<double> >(H, shifts);
+
+    MatrixXd T = MatrixXd::Zero(n, n);
+    T.diagonal() = m.diagonal();
+    T.diagonal(-1) = m.diagonal(-1);
+    T.diagonal(1) = m.diagonal(-1);
+    run_sweep_test< TridiagQR<double> >(T, shifts);
+}
+
 TEST_CASE("QR decomposition with double shifts", "QR")
 {
     srand(123);
@@ -0,0 +1,114 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::VectorXcd ComplexVector;
+
+// A symmetric matrix with a wide spread of eigenvalue magnitudes, so
+// that orthogonality of the basis degrades quickly without correction
+Matrix ill_conditioned_sym(int n)
+{
+    Vector d(n);
+    for(int i = 0; i < n; i++)
+        d[i] = std::pow(10.0, -8.0 + 10.0 * double(i) / double(n - 1));
+    Matrix A = Matrix::Random(n, n);
+    Matrix Q = Eigen::HouseholderQR<Matrix>(A).householderQ();
+    Matrix M = Q * d.asDiagonal() * Q.transpose();
+    return 0.5 * (M + M.transpose());
+}
+
+void run_sym(const Matrix &M, int rule, const Vector &ref)
+{
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 5, 20);
+    eigs.set_reorth_rule(rule);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(2000);
+
+    REQUIRE( nconv == 5 );
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    INFO( "rule = " << rule );
+    REQUIRE( (evals - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // The basis produced under the stricter strategies must stay
+    // orthogonal; check it through the computed eigenvectors
+    Matrix orth = evecs.transpose() * evecs - Matrix::Identity(nconv, nconv);
+    INFO( "||U'U - I||_inf = " << orth.cwiseAbs().maxCoeff() );
+    REQUIRE( orth.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Reorthogonalization strategies on an ill-conditioned matrix", "[reorth]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = ill_conditioned_sym(n);
+
+    Eigen::SelfAdjointEigenSolver<Matrix> es(M);
+    Vector all = es.eigenvalues();
+    Vector ref = all.tail(5).reverse();
+
+    run_sym(M, REORTH_STANDARD, ref);
+    run_sym(M, REORTH_DGKS, ref);
+    run_sym(M, REORTH_FULL, ref);
+}
+
+TEST_CASE("Disabling reorthogonalization on a well-behaved matrix", "[reorth]")
+{
+    srand(123);
+    const int n = 100;
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = A + A.transpose();
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 3, 10);
+    eigs.set_reorth_rule(REORTH_NONE);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(2000);
+
+    REQUIRE( nconv == 3 );
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Full reorthogonalization fires on every Arnoldi step", "[reorth]")
+{
+    srand(123);
+    const int n = 200;
+    Matrix A = Matrix::Random(n, n);
+
+    DenseGenMatProd<double> op(A);
+    GenEigsSolver< double, LARGEST_MAGN, DenseGenMatProd<double>,
+                   SolverStats<double> > eigs(&op, 5, 20);
+    eigs.set_reorth_rule(REORTH_FULL);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(2000);
+
+    REQUIRE( nconv == 5 );
+    // One correction pass per factorization step; the initial
+    // perform_op() in init() is not a factorization step
+    REQUIRE( eigs.stats().nreorth == eigs.num_operations() - 1 );
+
+    ComplexVector evals = eigs.eigenvalues();
+    Eigen::MatrixXcd evecs = eigs.eigenvectors();
+    Eigen::MatrixXcd err = A * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
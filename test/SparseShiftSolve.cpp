@@ -0,0 +1,130 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/SparseSymShiftSolve.h>
+#include <MatOp/SparseGenRealShiftSolve.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXcd ComplexMatrix;
+typedef Eigen::VectorXcd ComplexVector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+// Generate a sparse random matrix with approximately `prob` nonzero ratio
+SpMatrix gen_sparse_mat(int n, double prob)
+{
+    Matrix dense = Matrix::Random(n, n);
+    SpMatrix mat(n, n);
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+                mat.insert(i, j) = dense(i, j);
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+void run_test_sym(const SpMatrix &mat, int k, int m, double sigma)
+{
+    SparseSymShiftSolve<double> op(const_cast<SpMatrix &>(mat));
+    SymEigsShiftSolver<double, LARGEST_MAGN, SparseSymShiftSolve<double>> eigs(&op, k, m, sigma);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    Matrix err = mat * evecs - evecs * evals.asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+void run_test_gen(const SpMatrix &mat, int k, int m, double sigma)
+{
+    SparseGenRealShiftSolve<double> op(const_cast<SpMatrix &>(mat));
+    GenEigsRealShiftSolver<double, LARGEST_MAGN, SparseGenRealShiftSolve<double>> eigs(&op, k, m, sigma);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    REQUIRE( nconv > 0 );
+
+    ComplexVector evals = eigs.eigenvalues();
+    ComplexMatrix evecs = eigs.eigenvectors();
+
+    ComplexMatrix err = mat * evecs - evecs * evals.asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Shift-solve of sparse symmetric real matrix [100x100]", "[eigs_sym]")
+{
+    srand(123);
+
+    SpMatrix A = gen_sparse_mat(100, 0.1);
+    SpMatrix M = SpMatrix(A.transpose()) + A;
+    int k = 10;
+    int m = 20;
+    double sigma = 1.0;
+
+    run_test_sym(M, k, m, sigma);
+}
+
+TEST_CASE("Shift-solve of sparse symmetric real matrix [1000x1000]", "[eigs_sym]")
+{
+    srand(123);
+
+    SpMatrix A = gen_sparse_mat(1000, 0.01);
+    SpMatrix M = SpMatrix(A.transpose()) + A;
+    int k = 10;
+    int m = 30;
+    double sigma = 1.0;
+
+    run_test_sym(M, k, m, sigma);
+}
+
+TEST_CASE("Shift-solve of sparse general real matrix [100x100]", "[eigs_gen]")
+{
+    srand(123);
+
+    SpMatrix A = gen_sparse_mat(100, 0.1);
+    int k = 10;
+    int m = 30;
+    double sigma = 1.0;
+
+    run_test_gen(A, k, m, sigma);
+}
+
+TEST_CASE("Shift-solve of sparse general real matrix [1000x1000]", "[eigs_gen]")
+{
+    srand(123);
+
+    SpMatrix A = gen_sparse_mat(1000, 0.01);
+    int k = 10;
+    int m = 30;
+    double sigma = 1.0;
+
+    run_test_gen(A, k, m, sigma);
+}
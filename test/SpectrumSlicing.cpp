@@ -0,0 +1,112 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+#include <vector>
+
+#include <SymEigsSlicingSolver.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+// Reference eigenvalues of mat lying in [lower, upper], in increasing order
+Vector reference_window(const Matrix &mat, double lower, double upper)
+{
+    Eigen::SelfAdjointEigenSolver<Matrix> ref(mat);
+    Vector all = ref.eigenvalues();
+    std::vector<double> in;
+    for(int i = 0; i < all.size(); i++)
+    {
+        if(all[i] >= lower && all[i] <= upper)
+            in.push_back(all[i]);
+    }
+    Vector res(in.size());
+    for(unsigned int i = 0; i < in.size(); i++)
+        res[i] = in[i];
+    return res;
+}
+
+TEST_CASE("Spectrum slicing over an interval", "[slicing]")
+{
+    srand(123);
+
+    const int n = 100;
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = A + A.transpose();
+
+    const double lower = 0.0, upper = 6.0;
+    Vector ref = reference_window(M, lower, upper);
+    // The random matrix should put a reasonable number of eigenvalues
+    // in the window, otherwise the test is vacuous
+    REQUIRE( ref.size() >= 5 );
+
+    const int nslice = 4;
+    std::vector< DenseSymShiftSolve<double> > ops(nslice, DenseSymShiftSolve<double>(M));
+    std::vector< DenseSymShiftSolve<double>* > op_ptr(nslice);
+    for(int i = 0; i < nslice; i++)
+        op_ptr[i] = &ops[i];
+
+    // nev per slice is generous enough for adjacent slices to overlap
+    SymEigsSlicingSolver< double, DenseSymShiftSolve<double> >
+        eigs(&op_ptr[0], nslice, lower, upper, 10, 30);
+    int nfound = eigs.compute();
+
+    INFO( "nfound = " << nfound << ", reference = " << ref.size() );
+    REQUIRE( nfound == ref.size() );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    // Values match the reference, once each, in increasing order
+    REQUIRE( (evals - ref).cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // The merged eigenvectors belong to their eigenvalues
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Spectrum slicing with an explicit shift ladder", "[slicing]")
+{
+    srand(123);
+
+    const int n = 100;
+    Matrix A = Matrix::Random(n, n);
+    Matrix M = A + A.transpose();
+
+    // Deliberately close shifts, so that the slices overlap heavily and
+    // the deduplication has real work to do
+    const int nslice = 3;
+    double sigma[nslice] = {1.0, 1.5, 2.0};
+
+    std::vector< DenseSymShiftSolve<double> > ops(nslice, DenseSymShiftSolve<double>(M));
+    std::vector< DenseSymShiftSolve<double>* > op_ptr(nslice);
+    for(int i = 0; i < nslice; i++)
+        op_ptr[i] = &ops[i];
+
+    SymEigsSlicingSolver< double, DenseSymShiftSolve<double> >
+        eigs(&op_ptr[0], nslice, sigma, 8, 25);
+    int nfound = eigs.compute();
+
+    Vector evals = eigs.eigenvalues();
+    REQUIRE( nfound == evals.size() );
+    REQUIRE( nfound >= 8 );
+
+    // No duplicates survive the merge
+    for(int i = 1; i < nfound; i++)
+        REQUIRE( evals[i] - evals[i - 1] > 1e-8 );
+
+    // Every value is a true eigenvalue of M
+    Eigen::SelfAdjointEigenSolver<Matrix> ref(M);
+    Vector all = ref.eigenvalues();
+    for(int i = 0; i < nfound; i++)
+    {
+        double best = 1e300;
+        for(int j = 0; j < all.size(); j++)
+            best = std::min(best, std::abs(evals[i] - all[j]));
+        INFO( "i = " << i << ", distance to spectrum = " << best );
+        REQUIRE( best == Approx(0.0) );
+    }
+}
@@ -0,0 +1,95 @@
+#include <Eigen/Core>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <SolverStats.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+int callback_calls = 0;
+void count_callback(int iter, int nconv, double resid)
+{
+    callback_calls++;
+}
+
+TEST_CASE("Per-phase statistics, symmetric solver", "[stats]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(500, 500);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    DenseGenMatProd<double> op(M);
+
+    // Reference solve with the instrumentation compiled out
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> ref(&op, k, m);
+    srand(42);
+    ref.init();
+    int nconv_ref = ref.compute();
+    Vector evals_ref = ref.eigenvalues();
+
+    // Instrumented solve
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+                  SolverStats<double>> eigs(&op, k, m);
+    callback_calls = 0;
+    eigs.stats().iter_callback = count_callback;
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+    const SolverStats<double> &st = eigs.stats();
+
+    // The instrumentation must not change the results
+    REQUIRE( nconv == nconv_ref );
+    Vector evals = eigs.eigenvalues();
+    REQUIRE( (evals - evals_ref).array().abs().maxCoeff() == Approx(0.0) );
+
+    // Phase times and counts are populated
+    REQUIRE( st.time_op > 0.0 );
+    REQUIRE( st.time_ritz > 0.0 );
+    REQUIRE( st.nrestart == eigs.num_iterations() - 1 );
+
+    // One residual record and one callback invocation per iteration
+    REQUIRE( (int)st.resid_history.size() == eigs.num_iterations() );
+    REQUIRE( callback_calls == (int)st.resid_history.size() );
+    // The last recorded residual is below the convergence tolerance scale
+    REQUIRE( st.resid_history.back() < 1e-8 );
+
+    // init() clears the accumulated statistics but keeps the callback
+    srand(42);
+    eigs.init();
+    REQUIRE( eigs.stats().nrestart == 0 );
+    REQUIRE( eigs.stats().resid_history.empty() );
+    bool callback_kept = (eigs.stats().iter_callback == count_callback);
+    REQUIRE( callback_kept );
+}
+
+TEST_CASE("Per-phase statistics, general solver", "[stats]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(500, 500);
+    int k = 10;
+    int m = 30;
+
+    DenseGenMatProd<double> op(A);
+
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>,
+                  SolverStats<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    const SolverStats<double> &st = eigs.stats();
+
+    REQUIRE( nconv > 0 );
+    REQUIRE( st.time_op > 0.0 );
+    REQUIRE( st.time_ritz > 0.0 );
+    REQUIRE( st.nrestart == eigs.num_iterations() - 1 );
+    REQUIRE( (int)st.resid_history.size() == eigs.num_iterations() );
+}
@@ -0,0 +1,201 @@
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <iostream>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+// A symmetric matrix whose eigenvalues converge gradually, so that the
+// early-exit rules have something to cut short
+Matrix gen_sym_mat(int n)
+{
+    Matrix A = Matrix::Random(n, n);
+    return 0.5 * (A + A.transpose());
+}
+
+TEST_CASE("Early exit after the leading values have converged", "[stop_rule]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = gen_sym_mat(n);
+    const int k = 20;
+    const int m = 25;
+
+    // Reference run to full convergence
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs_full(&op, k, m);
+    srand(42);
+    eigs_full.init();
+    int nconv_full = eigs_full.compute();
+    int niter_full = eigs_full.num_iterations();
+    REQUIRE( nconv_full == k );
+
+    // Early exit as soon as the three best-converged values are in
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+    eigs.set_stop_rule(3);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv >= 3 );
+    REQUIRE( eigs.num_iterations() < niter_full );
+
+    // The values that did converge are genuine eigen pairs
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    Matrix err = M * evecs - evecs * evals.head(evecs.cols()).asDiagonal();
+    INFO( "||AV - VD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Per-Ritz-position tolerances", "[stop_rule]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = gen_sym_mat(n);
+    const int k = 10;
+    const int m = 14;
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs_full(&op, k, m);
+    srand(42);
+    eigs_full.init();
+    eigs_full.compute(1000, 1e-10);
+    int niter_full = eigs_full.num_iterations();
+
+    // Tight tolerance for the three leading values, loose for the rest
+    Vector tols(k);
+    tols.setConstant(1e-3);
+    tols.head(3).setConstant(1e-10);
+
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+    eigs.set_stop_tolerances(tols.data());
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute(1000, 1e-10);
+
+    REQUIRE( nconv == k );
+    REQUIRE( eigs.num_iterations() <= niter_full );
+
+    // The leading values still meet the tight tolerance
+    Eigen::SelfAdjointEigenSolver<Matrix> ref(M);
+    Vector evals = eigs.eigenvalues();
+    for(int i = 0; i < 3; i++)
+    {
+        double dist = (ref.eigenvalues().array() - evals[i]).abs().minCoeff();
+        REQUIRE( dist == Approx(0.0) );
+    }
+}
+
+// Callback bookkeeping for the tests below
+struct CallbackRecord
+{
+    int ncalls;
+    int last_nvals;
+    double last_resid;
+    int abort_after;
+};
+
+static bool observing_callback(int iter, int nconv, const double *ritz_val,
+                               const double *resid_est, int nvals, void *data)
+{
+    CallbackRecord *rec = static_cast<CallbackRecord *>(data);
+    rec->ncalls++;
+    rec->last_nvals = nvals;
+    rec->last_resid = resid_est[0];
+    // The Ritz values must be finite numbers
+    for(int i = 0; i < nvals; i++)
+    {
+        if(ritz_val[i] != ritz_val[i])
+            return false;
+    }
+    return rec->ncalls < rec->abort_after;
+}
+
+TEST_CASE("Per-iteration callback can observe and abort", "[stop_rule]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = gen_sym_mat(n);
+    const int k = 20;
+    const int m = 25;
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+
+    CallbackRecord rec = { 0, 0, 0.0, 3 };
+    eigs.set_iteration_callback(observing_callback, &rec);
+    srand(42);
+    eigs.init();
+    eigs.compute();
+
+    // Aborted on the third invocation, after two restarts
+    REQUIRE( rec.ncalls == 3 );
+    REQUIRE( rec.last_nvals == k );
+    REQUIRE( eigs.num_iterations() <= 3 );
+}
+
+TEST_CASE("Wall-clock budget stops the iterations", "[stop_rule]")
+{
+    srand(123);
+    const int n = 500;
+    Matrix M = gen_sym_mat(n);
+    const int k = 20;
+    const int m = 25;
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+    // A budget far below the time of one restart stops the solve at the
+    // first check
+    eigs.set_stop_rule(0, 1e-9);
+    srand(42);
+    eigs.init();
+    eigs.compute();
+
+    REQUIRE( eigs.num_iterations() <= 2 );
+}
+
+TEST_CASE("Stopping rules on the general solver", "[stop_rule]")
+{
+    srand(123);
+    const int n = 400;
+    Matrix A = Matrix::Random(n, n);
+    const int k = 6;
+    const int m = 20;
+
+    DenseGenMatProd<double> op(A);
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs_full(&op, k, m);
+    srand(42);
+    eigs_full.init();
+    int nconv_full = eigs_full.compute();
+    int niter_full = eigs_full.num_iterations();
+    REQUIRE( nconv_full == k );
+
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, k, m);
+    eigs.set_stop_rule(2);
+    srand(42);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv >= 2 );
+    REQUIRE( eigs.num_iterations() < niter_full );
+}
+
+TEST_CASE("Stopping rule rejects invalid input", "[stop_rule]")
+{
+    srand(123);
+    Matrix M = gen_sym_mat(20);
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double> > eigs(&op, 5, 10);
+
+    REQUIRE_THROWS( eigs.set_stop_rule(-1) );
+    REQUIRE_THROWS( eigs.set_stop_rule(6) );
+    REQUIRE_THROWS( eigs.set_stop_rule(3, -1.0) );
+}
@@ -0,0 +1,146 @@
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <iostream>
+
+#include <SymGEigsSolver.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::SparseMatrix<double> SpMatrix;
+
+// Generate a sparse symmetric random matrix with approximately
+// `prob` nonzero ratio
+SpMatrix gen_sym_sparse_mat(int n, double prob)
+{
+    Matrix dense = Matrix::Random(n, n);
+    SpMatrix mat(n, n);
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = j; i < n; i++)
+        {
+            if((rand() + 0.5) / (RAND_MAX + 1.0) < prob)
+            {
+                mat.insert(i, j) = dense(i, j);
+                if(i != j)
+                    mat.insert(j, i) = dense(i, j);
+            }
+        }
+    }
+    mat.makeCompressed();
+    return mat;
+}
+
+// Generate a sparse positive definite matrix: a symmetric sparse part
+// plus a dominant diagonal
+SpMatrix gen_spd_sparse_mat(int n, double prob)
+{
+    SpMatrix mat = gen_sym_sparse_mat(n, prob);
+    for(int i = 0; i < n; i++)
+        mat.coeffRef(i, i) += 2.0 + n * prob;
+    mat.makeCompressed();
+    return mat;
+}
+
+// Check the computed pairs against the definition A * v = lambda * B * v,
+// the B-orthonormality of the eigenvectors, and the dense reference
+// decomposition
+void check_result(const SpMatrix &A, const SpMatrix &B,
+                  const Vector &evals, const Matrix &evecs)
+{
+    int nconv = evals.size();
+
+    // Residuals of the generalized eigen pairs
+    Matrix err = A * evecs - B * evecs * evals.asDiagonal();
+    INFO( "||AV - BVD||_inf = " << err.cwiseAbs().maxCoeff() );
+    REQUIRE( err.cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // V'BV = I
+    Matrix orth = evecs.transpose() * B * evecs - Matrix::Identity(nconv, nconv);
+    REQUIRE( orth.cwiseAbs().maxCoeff() == Approx(0.0) );
+
+    // Each computed eigenvalue must appear in the dense reference spectrum
+    Matrix Ad(A), Bd(B);
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> ref(Ad, Bd);
+    double dist = 0.0;
+    for(int i = 0; i < nconv; i++)
+        dist = std::max(dist, (ref.eigenvalues().array() - evals[i]).abs().minCoeff());
+    REQUIRE( dist == Approx(0.0) );
+}
+
+TEST_CASE("Generalized eigen solver in the regular inverse mode", "[geigs_sym]")
+{
+    srand(123);
+    int n = 100;
+    SpMatrix A = gen_sym_sparse_mat(n, 0.1);
+    SpMatrix B = gen_spd_sparse_mat(n, 0.1);
+
+    int k = 5;
+    int m = 20;
+
+    SparseSymGenRegInvSolve<double> op(A, B);
+    SymGEigsSolver<double, LARGEST_MAGN, SparseSymGenRegInvSolve<double> > eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    int niter = eigs.num_iterations();
+    int nops = eigs.num_operations();
+
+    INFO( "nconv = " << nconv );
+    INFO( "niter = " << niter );
+    INFO( "nops = " << nops );
+    REQUIRE( nconv == k );
+
+    check_result(A, B, eigs.eigenvalues(), eigs.eigenvectors());
+}
+
+TEST_CASE("Generalized eigen solver in the shift-invert mode", "[geigs_sym]")
+{
+    srand(123);
+    int n = 100;
+    SpMatrix A = gen_sym_sparse_mat(n, 0.1);
+    SpMatrix B = gen_spd_sparse_mat(n, 0.1);
+
+    int k = 5;
+    int m = 20;
+    double sigma = 1.0;
+
+    SparseSymGenShiftSolve<double> op(A, B);
+    SymGEigsShiftSolver<double, LARGEST_MAGN, SparseSymGenShiftSolve<double> > eigs(&op, k, m, sigma);
+    eigs.init();
+    int nconv = eigs.compute();
+
+    REQUIRE( nconv == k );
+
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+    check_result(A, B, evals, evecs);
+
+    // The shift-invert solver with LARGEST_MAGN must return the
+    // eigenvalues closest to the shift
+    Matrix Ad(A), Bd(B);
+    Eigen::GeneralizedSelfAdjointEigenSolver<Matrix> ref(Ad, Bd);
+    Vector dist = (ref.eigenvalues().array() - sigma).abs();
+    std::sort(dist.data(), dist.data() + dist.size());
+    double maxdist = (evals.array() - sigma).abs().maxCoeff();
+    REQUIRE( maxdist <= dist[k - 1] * (1.0 + 1e-6) );
+}
+
+TEST_CASE("Generalized matrix operation wrappers reject invalid input", "[geigs_sym]")
+{
+    srand(123);
+    SpMatrix A = gen_sym_sparse_mat(10, 0.5);
+    SpMatrix B = gen_spd_sparse_mat(8, 0.5);
+
+    REQUIRE_THROWS( SparseSymGenRegInvSolve<double>(A, B) );
+    REQUIRE_THROWS( SparseSymGenShiftSolve<double>(A, B) );
+
+    // An indefinite "B" must be rejected by the Cholesky factorization
+    SpMatrix Bind = gen_sym_sparse_mat(10, 0.5);
+    for(int i = 0; i < 10; i++)
+        Bind.coeffRef(i, i) = (i % 2 == 0) ? 1.0 : -1.0;
+    REQUIRE_THROWS( SparseSymGenRegInvSolve<double>(A, Bind) );
+}
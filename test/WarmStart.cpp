@@ -0,0 +1,126 @@
+#include <Eigen/Core>
+#include <iostream>
+#include <vector>
+
+#include <SymEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+
+TEST_CASE("Resuming an interrupted computation", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    // Reference solve in one go
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> ref(&op, k, m);
+    ref.init();
+    int nconv_ref = ref.compute();
+    Vector evals_ref = ref.eigenvalues();
+
+    // Same solve in chunks of 2 iterations
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute(2);
+    int nchunk = 1;
+    while(nconv < k && nchunk < 100)
+    {
+        nconv = eigs.compute_continue(2);
+        nchunk++;
+    }
+
+    INFO( "nconv = " << nconv );
+    INFO( "nchunk = " << nchunk );
+    REQUIRE( nconv == nconv_ref );
+
+    Vector evals = eigs.eigenvalues();
+    REQUIRE( (evals - evals_ref).array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Checkpointing and restoring the factorization", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    // Run a few iterations and take a checkpoint
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    eigs.compute(3);
+
+    std::vector<double> state(eigs.state_size());
+    eigs.save_state(&state[0]);
+
+    // Restore into a fresh solver, as if the process had been restarted
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs2(&op, k, m);
+    eigs2.load_state(&state[0]);
+    int nconv = eigs2.compute_continue();
+
+    REQUIRE( nconv > 0 );
+
+    Vector evals = eigs2.eigenvalues();
+    Matrix evecs = eigs2.eigenvectors();
+    Matrix err = M * evecs - evecs * evals.asDiagonal();
+
+    INFO( "nconv = " << nconv );
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Warm-starting from a nearby matrix", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(500, 500);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    // Solve the first matrix in the sequence cold
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    REQUIRE( nconv == k );
+    Matrix evecs = eigs.eigenvectors();
+
+    // A small perturbation, as in a slowly-varying sequence A(t)
+    Matrix E = Eigen::MatrixXd::Random(500, 500);
+    Matrix M2 = M + 0.01 * (E + E.transpose());
+
+    // Cold solve of the perturbed matrix
+    DenseGenMatProd<double> op2(M2);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> cold(&op2, k, m);
+    cold.init();
+    int nconv_cold = cold.compute();
+    REQUIRE( nconv_cold == k );
+
+    // Warm solve seeded with the eigenvectors of the previous matrix
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> warm(&op2, k, m);
+    warm.init(evecs.data(), evecs.cols());
+    int nconv_warm = warm.compute();
+    REQUIRE( nconv_warm == k );
+
+    INFO( "cold niter = " << cold.num_iterations() );
+    INFO( "warm niter = " << warm.num_iterations() );
+    REQUIRE( warm.num_iterations() <= cold.num_iterations() );
+
+    Vector evals = warm.eigenvalues();
+    Matrix evecs2 = warm.eigenvectors();
+    Matrix err = M2 * evecs2 - evecs2 * evals.asDiagonal();
+    INFO( "||AU - UD||_inf = " << err.array().abs().maxCoeff() );
+    REQUIRE( err.array().abs().maxCoeff() == Approx(0.0) );
+}
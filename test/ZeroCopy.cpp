@@ -0,0 +1,82 @@
+#include <Eigen/Core>
+#include <iostream>
+#include <vector>
+
+#include <SymEigsSolver.h>
+#include <GenEigsSolver.h>
+#include <MatOp/DenseGenMatProd.h>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+typedef Eigen::MatrixXd Matrix;
+typedef Eigen::VectorXd Vector;
+typedef Eigen::MatrixXcd ComplexMatrix;
+typedef Eigen::VectorXcd ComplexVector;
+
+TEST_CASE("Caller-buffer retrieval, symmetric solver", "[eigs_sym]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    Matrix M = A + A.transpose();
+    int k = 10;
+    int m = 20;
+
+    DenseGenMatProd<double> op(M);
+    SymEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    REQUIRE( nconv > 0 );
+    REQUIRE( eigs.num_converged_eigenvalues() == nconv );
+
+    // The by-value and the caller-buffer retrievals must agree
+    Vector evals = eigs.eigenvalues();
+    Matrix evecs = eigs.eigenvectors();
+
+    std::vector<double> val_buf(nconv);
+    std::vector<double> vec_buf(100 * nconv);
+    eigs.eigenvalues(&val_buf[0]);
+    eigs.eigenvectors(&vec_buf[0], nconv);
+
+    Eigen::Map<Vector> evals2(&val_buf[0], nconv);
+    Eigen::Map<Matrix> evecs2(&vec_buf[0], 100, nconv);
+    REQUIRE( (evals - evals2).array().abs().maxCoeff() == Approx(0.0) );
+    REQUIRE( (evecs - evecs2).array().abs().maxCoeff() == Approx(0.0) );
+
+    // A single column through the lazy basis() / ritz_vectors() views
+    Vector v0 = eigs.basis() * eigs.ritz_vectors().col(0);
+    REQUIRE( (v0 - evecs.col(0)).array().abs().maxCoeff() == Approx(0.0) );
+}
+
+TEST_CASE("Caller-buffer retrieval, general solver", "[eigs_gen]")
+{
+    srand(123);
+
+    Matrix A = Eigen::MatrixXd::Random(100, 100);
+    int k = 10;
+    int m = 30;
+
+    DenseGenMatProd<double> op(A);
+    GenEigsSolver<double, LARGEST_MAGN, DenseGenMatProd<double>> eigs(&op, k, m);
+    eigs.init();
+    int nconv = eigs.compute();
+    REQUIRE( nconv > 0 );
+    REQUIRE( eigs.num_converged_eigenvalues() == nconv );
+
+    ComplexVector evals = eigs.eigenvalues();
+    ComplexMatrix evecs = eigs.eigenvectors();
+
+    std::vector<std::complex<double>> val_buf(nconv);
+    std::vector<std::complex<double>> vec_buf(100 * nconv);
+    eigs.eigenvalues(&val_buf[0]);
+    eigs.eigenvectors(&vec_buf[0], nconv);
+
+    Eigen::Map<ComplexVector> evals2(&val_buf[0], nconv);
+    Eigen::Map<ComplexMatrix> evecs2(&vec_buf[0], 100, nconv);
+    REQUIRE( (evals - evals2).array().abs().maxCoeff() == Approx(0.0) );
+    REQUIRE( (evecs - evecs2).array().abs().maxCoeff() == Approx(0.0) );
+
+    ComplexVector v0 = eigs.basis() * eigs.ritz_vectors().col(0);
+    REQUIRE( (v0 - evecs.col(0)).array().abs().maxCoeff() == Approx(0.0) );
+}